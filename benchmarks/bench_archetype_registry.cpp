@@ -0,0 +1,122 @@
+#include "ECS/ECS.h"
+#include "ECS/CoreTypes.h"
+#include "ECS/Archetype/ArchetypeRegistry.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+// several game instances in one process loading levels against one archetype registry
+// every instance creates the archetypes of its level, most of them shared with the other instances
+// rebuild with PUNK_ARCHETYPE_REGISTRY_SHARD_COUNT=1 to compare against a single registry lock
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <size_t I>
+    struct bench_component_t
+    {
+        using component_tag = punk::data_component_tag;
+
+        float       value;
+        uint32_t    id;
+    };
+
+    constexpr size_t component_type_count = 48;
+    constexpr size_t archetypes_per_level = 4'000;
+    constexpr size_t level_loads = 8;
+
+    template <size_t ... Indices>
+    auto make_component_types(punk::runtime_type_registry_t* rtts, std::index_sequence<Indices...>)
+    {
+        return std::array<punk::type_info_t const*, sizeof...(Indices)>{ rtts->get_or_create_type_info<bench_component_t<Indices>>()... };
+    }
+
+    // a level is a list of component combinations, instances share most of them
+    std::vector<std::vector<punk::type_info_t const*>> make_level(std::array<punk::type_info_t const*, component_type_count> const& component_types, uint64_t seed)
+    {
+        std::mt19937_64 engine{ seed };
+        std::vector<std::vector<punk::type_info_t const*>> level(archetypes_per_level);
+        for(auto& signature : level)
+        {
+            auto const count = 2 + engine() % 7;
+            for(size_t loop = 0; loop < count; ++loop)
+            {
+                signature.push_back(component_types[engine() % component_type_count]);
+            }
+        }
+        return level;
+    }
+
+    void run_case(punk::runtime_type_registry_t* rtts, std::array<punk::type_info_t const*, component_type_count> const& component_types, size_t instance_count)
+    {
+        std::unique_ptr<punk::archetype_registry_t> archetype_system
+        {
+            punk::archetype_registry_t::create_instance(rtts)
+        };
+
+        std::vector<std::vector<std::vector<punk::type_info_t const*>>> levels;
+        for(size_t instance = 0; instance < instance_count; ++instance)
+        {
+            // instances run the same content, with a few unique archetypes each
+            levels.push_back(make_level(component_types, 0x78656373 + instance % 2));
+        }
+
+        std::atomic<bool> start{ false };
+        std::vector<std::thread> instances;
+        for(size_t instance = 0; instance < instance_count; ++instance)
+        {
+            instances.emplace_back([&, instance]()
+            {
+                while(!start.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+
+                for(size_t load = 0; load < level_loads; ++load)
+                {
+                    // the loaded level keeps its archetypes alive until the next load
+                    std::vector<punk::archetype_ptr> loaded;
+                    loaded.reserve(archetypes_per_level);
+                    for(auto signature : levels[instance])
+                    {
+                        loaded.push_back(archetype_system->get_or_create_archetype(signature.data(), signature.size()));
+                    }
+                }
+            });
+        }
+
+        auto const begin = clock_type::now();
+        start.store(true, std::memory_order_release);
+        for(auto& instance : instances)
+        {
+            instance.join();
+        }
+        auto const seconds = std::chrono::duration<double>(clock_type::now() - begin).count();
+
+        auto const stats = archetype_system->get_stats();
+        auto const creations = static_cast<double>(instance_count * level_loads * archetypes_per_level);
+        std::printf("%2zu instances %10.2f ms %8.1f ns/archetype  locks %8llu  contended %8llu (%5.2f%%)  rebuilds %6llu\n",
+            instance_count, seconds * 1e3, seconds * 1e9 / creations,
+            static_cast<unsigned long long>(stats.lock_acquisitions),
+            static_cast<unsigned long long>(stats.lock_contentions),
+            stats.lock_acquisitions ? 100.0 * static_cast<double>(stats.lock_contentions) / static_cast<double>(stats.lock_acquisitions) : 0.0,
+            static_cast<unsigned long long>(stats.table_rebuilds));
+    }
+}
+
+int main()
+{
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    auto const component_types = make_component_types(rtts.get(), std::make_index_sequence<component_type_count>{});
+
+    std::printf("archetype registry, %zu shards\n", punk::archetype_registry_impl::shard_count);
+    for(size_t const instance_count : { 1, 2, 4, 8 })
+    {
+        run_case(rtts.get(), component_types, instance_count);
+    }
+    return 0;
+}
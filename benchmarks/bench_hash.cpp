@@ -0,0 +1,135 @@
+#include "Base/Types.h"
+#include "Base/Utils/Hash.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+// throughput of hash_memory (murmur3 x86_32) against hash_memory64 on the inputs the engine hashes
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct workload_t
+    {
+        char const*                         name;
+        std::vector<std::string>            inputs;
+        size_t                              iterations;
+    };
+
+    template <typename HashFunc>
+    void run_case(char const* hash_name, workload_t const& workload, HashFunc&& hash_func)
+    {
+        size_t total_bytes = 0;
+        for(auto const& input : workload.inputs)
+        {
+            total_bytes += input.size();
+        }
+
+        // the sink keeps the calls from being optimized away
+        uint64_t sink = 0;
+        auto const begin = clock_type::now();
+        for(size_t iteration = 0; iteration < workload.iterations; ++iteration)
+        {
+            for(auto const& input : workload.inputs)
+            {
+                sink += hash_func(input.data(), input.size());
+            }
+        }
+        auto const seconds = std::chrono::duration<double>(clock_type::now() - begin).count();
+
+        auto const hash_count = static_cast<double>(workload.inputs.size() * workload.iterations);
+        auto const bytes = static_cast<double>(total_bytes * workload.iterations);
+        std::printf("%-22s %-24s %10.2f MB/s %10.2f ns/hash  (%016llx)\n",
+            workload.name, hash_name, bytes / seconds / (1024.0 * 1024.0), seconds * 1e9 / hash_count,
+            static_cast<unsigned long long>(sink));
+    }
+
+    workload_t make_type_names()
+    {
+        return
+        {
+            "type names",
+            {
+                "bool", "float3", "matrix4x4", "punk::handle<punk::entity_t, uint32>",
+                "transform_component_t", "hierarchy_component_t", "aabb_component_t",
+                "std::vector<std::array<float4, 4>>", "punk::render::static_mesh_component",
+            },
+            2'000'000
+        };
+    }
+
+    workload_t make_archetype_signatures(std::mt19937_64& engine)
+    {
+        // sorted 32-bit component name hashes, 2 to 16 components
+        workload_t workload{ "archetype signatures", {}, 500'000 };
+        for(size_t count = 2; count <= 16; count += 2)
+        {
+            std::vector<uint32_t> hashes(count);
+            std::ranges::generate(hashes, [&]() { return static_cast<uint32_t>(engine()); });
+            std::ranges::sort(hashes);
+            workload.inputs.emplace_back(reinterpret_cast<char const*>(hashes.data()), hashes.size() * sizeof(uint32_t));
+        }
+        return workload;
+    }
+
+    workload_t make_chunk_payloads(std::mt19937_64& engine)
+    {
+        // whole 16 KB chunks, e.g. replication checksums
+        workload_t workload{ "16 KB chunk payloads", {}, 4'000 };
+        for(size_t loop = 0; loop < 8; ++loop)
+        {
+            std::string payload(16 * 1024, '\0');
+            std::ranges::generate(payload, [&]() { return static_cast<char>(engine()); });
+            workload.inputs.push_back(std::move(payload));
+        }
+        return workload;
+    }
+}
+
+int main()
+{
+    using namespace punk;
+
+    std::mt19937_64 engine{ 0x78656373 };
+    workload_t const workloads[] =
+    {
+        make_type_names(),
+        make_archetype_signatures(engine),
+        make_chunk_payloads(engine),
+    };
+
+    for(auto const& workload : workloads)
+    {
+        run_case("murmur3 x86_32", workload,
+            [](char const* data, size_t len) { return static_cast<uint64_t>(hash_memory(data, len)); });
+        run_case("hash_memory64", workload,
+            [](char const* data, size_t len) { return hash_memory64(data, len); });
+
+        // each bulk kernel level on its own, only long inputs reach them
+        for(auto const level : { detail::hash_kernel_level::scalar, detail::hash_kernel_level::sse2, detail::hash_kernel_level::avx2 })
+        {
+            if(level > detail::detect_hash_kernel_level())
+            {
+                continue;
+            }
+
+            auto const kernels = detail::make_hash_kernels(level);
+            if(kernels.level != level)
+            {
+                continue;
+            }
+
+            char const* const level_names[] = { "hash_memory64 scalar", "hash_memory64 sse2", "hash_memory64 avx2" };
+            run_case(level_names[static_cast<size_t>(level)], workload,
+                [&kernels](char const* data, size_t len)
+                {
+                    return len <= detail::hash_bulk_threshold
+                        ? detail::wyhash(data, len, 0x78656373)
+                        : detail::hash_bulk(data, len, 0x78656373, kernels.accumulate, kernels.scramble);
+                });
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
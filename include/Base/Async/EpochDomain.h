@@ -0,0 +1,176 @@
+#pragma once
+
+#include "Base/Types.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <assert.h>
+
+#ifndef PUNK_EPOCH_DOMAIN_READER_SLOTS
+#define PUNK_EPOCH_DOMAIN_READER_SLOTS 128
+#endif
+
+#ifndef PUNK_EPOCH_DOMAIN_COLLECT_THRESHOLD
+#define PUNK_EPOCH_DOMAIN_COLLECT_THRESHOLD 64
+#endif
+
+namespace punk
+{
+    // epoch based reclamation, readers pin the domain instead of touching a reference count
+    //  pin     : one store to a reader slot picked by thread id, no shared cache line in the common case
+    //  retire  : an unlinked object is freed once every reader pinned before its retirement has left
+    // objects must be unreachable for new readers before they are retired
+    class epoch_domain
+    {
+    public:
+        static constexpr size_t reader_slot_count = PUNK_EPOCH_DOMAIN_READER_SLOTS;
+        static constexpr size_t collect_threshold = PUNK_EPOCH_DOMAIN_COLLECT_THRESHOLD;
+        static constexpr uint64_t inactive_epoch = 0;
+
+        class guard
+        {
+        private:
+            std::atomic<uint64_t>*  slot_;
+
+        public:
+            explicit guard(std::atomic<uint64_t>* slot) noexcept : slot_(slot) {}
+            ~guard() { release(); }
+            guard(guard const&) = delete;
+            guard& operator=(guard const&) = delete;
+            guard(guard&& other) noexcept : slot_(std::exchange(other.slot_, nullptr)) {}
+            guard& operator=(guard&& other) noexcept
+            {
+                if(this != &other)
+                {
+                    release();
+                    slot_ = std::exchange(other.slot_, nullptr);
+                }
+                return *this;
+            }
+
+            void release() noexcept
+            {
+                if(slot_)
+                {
+                    slot_->store(inactive_epoch, std::memory_order_release);
+                    slot_ = nullptr;
+                }
+            }
+        };
+
+    private:
+        struct alignas(64) reader_slot_t
+        {
+            std::atomic<uint64_t>   epoch{ inactive_epoch };
+        };
+
+        struct retired_t
+        {
+            uint64_t                epoch;
+            void*                   object;
+            void                    (*deleter)(void*);
+        };
+
+        std::atomic<uint64_t>                           global_epoch_{ 1 };
+        std::array<reader_slot_t, reader_slot_count>    reader_slots_;
+        std::mutex                                      retired_lock_;
+        std::vector<retired_t>                          retired_;
+
+    public:
+        epoch_domain() = default;
+        epoch_domain(epoch_domain const&) = delete;
+        epoch_domain& operator=(epoch_domain const&) = delete;
+
+        ~epoch_domain()
+        {
+            assert(std::ranges::all_of(reader_slots_, [](auto const& slot) { return slot.epoch.load() == inactive_epoch; }));
+            for(auto const& retired : retired_)
+            {
+                retired.deleter(retired.object);
+            }
+        }
+
+    public:
+        // objects reachable when pinned stay alive until the guard is released
+        [[nodiscard]] guard pin() noexcept
+        {
+            auto const start = std::hash<std::thread::id>{}(std::this_thread::get_id());
+            for(size_t probe = 0; ; ++probe)
+            {
+                auto& slot = reader_slots_[(start + probe) % reader_slot_count].epoch;
+                auto expected = inactive_epoch;
+                // seq_cst orders the slot store before any read of the protected structure
+                if(slot.compare_exchange_strong(expected, global_epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst))
+                {
+                    return guard{ &slot };
+                }
+                if(probe >= reader_slot_count)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        template <typename T>
+        void retire(T* object)
+        {
+            retire(object, [](void* retired_object) { delete static_cast<T*>(retired_object); });
+        }
+
+        void retire(void* object, void (*deleter)(void*))
+        {
+            bool should_collect;
+            {
+                std::scoped_lock lock{ retired_lock_ };
+                retired_.push_back({ global_epoch_.load(std::memory_order_seq_cst), object, deleter });
+                should_collect = retired_.size() >= collect_threshold;
+            }
+
+            if(should_collect)
+            {
+                collect();
+            }
+        }
+
+        // advance the epoch & free what no reader can still see, returns the number of freed objects
+        size_t collect()
+        {
+            std::vector<retired_t> reclaimable;
+            {
+                std::scoped_lock lock{ retired_lock_ };
+                auto const safe_epoch = (std::min)(global_epoch_.fetch_add(1, std::memory_order_seq_cst) + 1, oldest_reader_epoch());
+                auto const split = std::ranges::partition(retired_, [safe_epoch](auto const& retired) { return retired.epoch >= safe_epoch; });
+                reclaimable.assign(split.begin(), split.end());
+                retired_.erase(split.begin(), split.end());
+            }
+
+            for(auto const& retired : reclaimable)
+            {
+                retired.deleter(retired.object);
+            }
+            return reclaimable.size();
+        }
+
+        size_t retired_count()
+        {
+            std::scoped_lock lock{ retired_lock_ };
+            return retired_.size();
+        }
+
+    private:
+        uint64_t oldest_reader_epoch() const noexcept
+        {
+            auto oldest = (std::numeric_limits<uint64_t>::max)();
+            for(auto const& slot : reader_slots_)
+            {
+                auto const epoch = slot.epoch.load(std::memory_order_seq_cst);
+                if(epoch != inactive_epoch)
+                {
+                    oldest = (std::min)(oldest, epoch);
+                }
+            }
+            return oldest;
+        }
+    };
+}
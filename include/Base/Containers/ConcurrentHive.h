@@ -0,0 +1,480 @@
+#pragma once
+
+#include "Base/Types.h"
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <assert.h>
+
+#ifndef PUNK_CONCURRENT_HIVE_GROUP_CAPACITY
+#define PUNK_CONCURRENT_HIVE_GROUP_CAPACITY 128
+#endif
+
+#ifndef PUNK_CONCURRENT_HIVE_SHARD_COUNT
+#define PUNK_CONCURRENT_HIVE_SHARD_COUNT 16
+#endif
+
+namespace punk::detail
+{
+    // every thread touching any concurrent hive gets a small stable id, used to pick its current group
+    inline std::atomic<uint32_t> concurrent_hive_thread_counter{ 0 };
+
+    inline uint32_t concurrent_hive_thread_slot() noexcept
+    {
+        thread_local uint32_t const slot = concurrent_hive_thread_counter.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+}
+
+namespace punk
+{
+    // a fixed capacity group, slots are claimed & released by atomic bit operations only
+    template <typename T, size_t Capacity>
+    class concurrent_hive_group
+    {
+    public:
+        using value_type = T;
+        using pointer = std::add_pointer_t<value_type>;
+        using const_pointer = std::add_pointer_t<std::add_const_t<value_type>>;
+        using word_type = uint64_t;
+        static constexpr size_t bits_per_word = std::numeric_limits<word_type>::digits;
+        static constexpr size_t word_count = (Capacity + bits_per_word - 1) / bits_per_word;
+        static constexpr size_t npos = (std::numeric_limits<size_t>::max)();
+
+        union element_storage
+        {
+            alignas(T) std::array<uint8_t, sizeof(T)> bytes_;
+        };
+
+    private:
+        // claimed_bits_ owns the slot, live_bits_ publishes the constructed value to readers
+        std::array<std::atomic<word_type>, word_count>  claimed_bits_;
+        std::array<std::atomic<word_type>, word_count>  live_bits_;
+        std::atomic<size_t>                             available_element_count_;
+        size_t const                                    first_global_index_;
+        std::unique_ptr<element_storage[]>              storage_;
+
+    public:
+        explicit concurrent_hive_group(size_t first_global_index)
+            : available_element_count_(Capacity)
+            , first_global_index_(first_global_index)
+            , storage_(new element_storage[Capacity]{})
+        {
+            for(size_t loop = 0; loop < word_count; ++loop)
+            {
+                claimed_bits_[loop].store(tail_mask(loop), std::memory_order_relaxed);
+                live_bits_[loop].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        ~concurrent_hive_group()
+        {
+            if constexpr(!std::is_trivially_destructible_v<value_type>)
+            {
+                for(size_t loop = 0; loop < Capacity; ++loop)
+                {
+                    if(test(loop))
+                    {
+                        get_ptr(loop)->~value_type();
+                    }
+                }
+            }
+        }
+
+        concurrent_hive_group(concurrent_hive_group const&) = delete;
+        concurrent_hive_group& operator=(concurrent_hive_group const&) = delete;
+
+    public:
+        static constexpr size_t capacity() noexcept
+        {
+            return Capacity;
+        }
+
+        size_t size() const noexcept
+        {
+            return capacity() - available_element_count_.load(std::memory_order_relaxed);
+        }
+
+        bool has_available_space() const noexcept
+        {
+            return available_element_count_.load(std::memory_order_relaxed) > 0;
+        }
+
+        size_t get_first_global_index() const noexcept
+        {
+            return first_global_index_;
+        }
+
+        bool test(size_t index) const noexcept
+        {
+            assert(index < capacity());
+            auto const word = live_bits_[index / bits_per_word].load(std::memory_order_acquire);
+            return (word & bit_of(index)) != 0;
+        }
+
+        pointer get(size_t index) noexcept
+        {
+            return test(index) ? get_ptr(index) : nullptr;
+        }
+
+        const_pointer get(size_t index) const noexcept
+        {
+            return test(index) ? get_ptr(index) : nullptr;
+        }
+
+    public:
+        // pop any free slot, returns npos when the group is full
+        size_t claim() noexcept
+        {
+            if(!has_available_space())
+            {
+                return npos;
+            }
+
+            for(size_t word_index = 0; word_index < word_count; ++word_index)
+            {
+                auto& bits = claimed_bits_[word_index];
+                auto word = bits.load(std::memory_order_relaxed);
+                while(word != (std::numeric_limits<word_type>::max)())
+                {
+                    auto const bit_index = static_cast<size_t>(std::countr_one(word));
+                    if(bits.compare_exchange_weak(word, word | (word_type{ 1 } << bit_index), std::memory_order_acquire, std::memory_order_relaxed))
+                    {
+                        available_element_count_.fetch_sub(1, std::memory_order_relaxed);
+                        return word_index * bits_per_word + bit_index;
+                    }
+                }
+            }
+            return npos;
+        }
+
+        // claim a specific slot, returns false when the slot is owned by someone else
+        bool claim_at(size_t index) noexcept
+        {
+            assert(index < capacity());
+            auto const previous = claimed_bits_[index / bits_per_word].fetch_or(bit_of(index), std::memory_order_acquire);
+            if((previous & bit_of(index)) != 0)
+            {
+                return false;
+            }
+            available_element_count_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        template <typename ... Args>
+        pointer construct_at_claimed(size_t index, Args&& ... args)
+        {
+            new (storage_[index].bytes_.data()) value_type{ std::forward<Args>(args)... };
+            return publish(index);
+        }
+
+        // publishes a claimed slot without constructing, the value keeps the bytes its last occupant left
+        pointer revive_at_claimed(size_t index) noexcept requires std::is_trivially_copyable_v<value_type>
+        {
+            return publish(index);
+        }
+
+        bool destruct(size_t index) noexcept
+        {
+            assert(index < capacity());
+
+            // the thread clearing the live bit owns the destruction, so a double free is a no-op
+            auto const previous = live_bits_[index / bits_per_word].fetch_and(~bit_of(index), std::memory_order_acq_rel);
+            if((previous & bit_of(index)) == 0)
+            {
+                return false;
+            }
+
+            if constexpr(!std::is_trivially_destructible_v<value_type>)
+            {
+                get_ptr(index)->~value_type();
+            }
+
+            // hand the slot back to producers
+            claimed_bits_[index / bits_per_word].fetch_and(~bit_of(index), std::memory_order_release);
+            available_element_count_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+    private:
+        pointer publish(size_t index) noexcept
+        {
+            live_bits_[index / bits_per_word].fetch_or(bit_of(index), std::memory_order_release);
+            return get_ptr(index);
+        }
+
+        static constexpr word_type bit_of(size_t index) noexcept
+        {
+            return word_type{ 1 } << (index % bits_per_word);
+        }
+
+        // bits beyond the capacity are permanently claimed
+        static constexpr word_type tail_mask(size_t word_index) noexcept
+        {
+            auto const first_bit = word_index * bits_per_word;
+            if(first_bit + bits_per_word <= Capacity)
+            {
+                return 0;
+            }
+            return ~((word_type{ 1 } << (Capacity - first_bit)) - 1);
+        }
+
+        pointer get_ptr(size_t index) const noexcept
+        {
+            return std::launder(reinterpret_cast<pointer>(storage_[index].bytes_.data()));
+        }
+    };
+
+    // multi-producer hive, threads construct into per-thread current groups and only group creation takes a lock
+    template <typename T, typename Alloc = std::allocator<T>>
+    class concurrent_hive
+    {
+    public:
+        static constexpr size_t hive_group_capacity = PUNK_CONCURRENT_HIVE_GROUP_CAPACITY;
+        static constexpr size_t shard_count = PUNK_CONCURRENT_HIVE_SHARD_COUNT;
+        using hive_group_type = concurrent_hive_group<T, hive_group_capacity>;
+        using value_type = T;
+        using pointer = typename hive_group_type::pointer;
+        using const_pointer = typename hive_group_type::const_pointer;
+        using allocator_type = Alloc;
+
+        static_assert(std::has_single_bit(shard_count));
+
+    private:
+        // group directory, grown by copy & publish, superseded directories stay alive until the hive dies
+        struct group_directory
+        {
+            size_t                                          capacity;
+            std::unique_ptr<std::atomic<hive_group_type*>[]> groups;
+        };
+        using hive_group_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<hive_group_type>;
+
+        std::atomic<group_directory*>                       directory_;
+        std::atomic<size_t>                                 group_count_;
+        std::array<std::atomic<size_t>, shard_count>        current_groups_;
+        std::mutex                                          group_mutex_;
+        std::vector<std::unique_ptr<group_directory>>       directories_;
+
+    public:
+        concurrent_hive()
+            : directory_(nullptr)
+            , group_count_(0)
+        {
+            for(auto& current_group : current_groups_)
+            {
+                current_group.store(0, std::memory_order_relaxed);
+            }
+            std::scoped_lock lock{ group_mutex_ };
+            append_new_group_locked();
+        }
+
+        ~concurrent_hive()
+        {
+            auto* directory = directory_.load(std::memory_order_acquire);
+            auto const group_count = group_count_.load(std::memory_order_acquire);
+            for(size_t loop = 0; loop < group_count; ++loop)
+            {
+                destroy_group(directory->groups[loop].load(std::memory_order_relaxed));
+            }
+        }
+
+        concurrent_hive(concurrent_hive const&) = delete;
+        concurrent_hive& operator=(concurrent_hive const&) = delete;
+        concurrent_hive(concurrent_hive&&) = delete;
+        concurrent_hive& operator=(concurrent_hive&&) = delete;
+
+    public:
+        template <typename ... Args>
+        auto construct(Args&& ... args) -> std::pair<pointer, size_t>
+        {
+            auto const [group, index_in_group] = claim_any();
+            auto* value_ptr = group->construct_at_claimed(index_in_group, std::forward<Args>(args)...);
+            return { value_ptr, group->get_first_global_index() + index_in_group };
+        }
+
+        // the slot is taken when constructing fails, a nullptr means another thread is constructing or destroying it
+        template <typename ... Args>
+        auto construct_at(size_t index, bool overwrite_when_constructed, Args&& ... args) -> std::pair<pointer, bool>
+        {
+            auto const index_in_group = index % hive_group_capacity;
+            auto* group = ensure_group_of(index);
+            if(group->claim_at(index_in_group))
+            {
+                return { group->construct_at_claimed(index_in_group, std::forward<Args>(args)...), true };
+            }
+
+            // the slot is taken, either constructed or being constructed by another thread
+            auto* value_ptr = group->get(index_in_group);
+            if(value_ptr && overwrite_when_constructed)
+            {
+                *value_ptr = value_type{ std::forward<Args>(args)... };
+                return { value_ptr, true };
+            }
+            return { value_ptr, false };
+        }
+
+        // retained values: revive takes a free slot without constructing, the value keeps the bytes its last occupant
+        // left, zeros for a slot never used, so e.g. a generation counter bumped on destruct survives reuse
+        auto revive() -> std::pair<pointer, size_t> requires std::is_trivially_copyable_v<value_type>
+        {
+            auto const [group, index_in_group] = claim_any();
+            return { group->revive_at_claimed(index_in_group), group->get_first_global_index() + index_in_group };
+        }
+
+        // the live value when the slot is taken, nullptr while another thread is constructing or destroying it
+        auto revive_at(size_t index) -> std::pair<pointer, bool> requires std::is_trivially_copyable_v<value_type>
+        {
+            auto const index_in_group = index % hive_group_capacity;
+            auto* group = ensure_group_of(index);
+            if(group->claim_at(index_in_group))
+            {
+                return { group->revive_at_claimed(index_in_group), true };
+            }
+            return { group->get(index_in_group), false };
+        }
+
+        bool destruct(size_t index) noexcept
+        {
+            auto* group = find_group(index);
+            return group ? group->destruct(index % hive_group_capacity) : false;
+        }
+
+        pointer get(size_t index) noexcept
+        {
+            auto* group = find_group(index);
+            return group ? group->get(index % hive_group_capacity) : nullptr;
+        }
+
+        const_pointer get(size_t index) const noexcept
+        {
+            return const_cast<concurrent_hive*>(this)->get(index);
+        }
+
+        size_t capacity() const noexcept
+        {
+            return group_count_.load(std::memory_order_acquire) * hive_group_capacity;
+        }
+
+    private:
+        auto claim_any() -> std::pair<hive_group_type*, size_t>
+        {
+            auto& current_group = current_groups_[detail::concurrent_hive_thread_slot() & (shard_count - 1)];
+            auto group_index = current_group.load(std::memory_order_relaxed);
+
+            // fast path: the current group of this thread
+            auto* group = get_group(group_index);
+            auto index_in_group = group->claim();
+
+            // slow path: look for any group with space, otherwise create one
+            while(index_in_group == hive_group_type::npos)
+            {
+                group_index = find_or_append_available_group(group_index);
+                group = get_group(group_index);
+                index_in_group = group->claim();
+            }
+            current_group.store(group_index, std::memory_order_relaxed);
+            return { group, index_in_group };
+        }
+
+        hive_group_type* ensure_group_of(size_t index)
+        {
+            auto const index_of_group = index / hive_group_capacity;
+            ensure_group_count(index_of_group + 1);
+            return get_group(index_of_group);
+        }
+
+        hive_group_type* get_group(size_t index_of_group) const noexcept
+        {
+            auto* directory = directory_.load(std::memory_order_acquire);
+            assert(index_of_group < directory->capacity);
+            return directory->groups[index_of_group].load(std::memory_order_acquire);
+        }
+
+        hive_group_type* find_group(size_t index) const noexcept
+        {
+            auto const index_of_group = index / hive_group_capacity;
+            if(index_of_group >= group_count_.load(std::memory_order_acquire))
+            {
+                return nullptr;
+            }
+            return get_group(index_of_group);
+        }
+
+        size_t find_or_append_available_group(size_t full_group_index)
+        {
+            auto const group_count = group_count_.load(std::memory_order_acquire);
+            for(size_t loop = 1; loop <= group_count; ++loop)
+            {
+                auto const group_index = (full_group_index + loop) % group_count;
+                if(get_group(group_index)->has_available_space())
+                {
+                    return group_index;
+                }
+            }
+
+            // the only synchronized step, re-check in case another producer already appended
+            std::scoped_lock lock{ group_mutex_ };
+            if(group_count_.load(std::memory_order_relaxed) != group_count)
+            {
+                return group_count;
+            }
+            return append_new_group_locked();
+        }
+
+        void ensure_group_count(size_t group_count)
+        {
+            if(group_count_.load(std::memory_order_acquire) >= group_count)
+            {
+                return;
+            }
+
+            std::scoped_lock lock{ group_mutex_ };
+            while(group_count_.load(std::memory_order_relaxed) < group_count)
+            {
+                append_new_group_locked();
+            }
+        }
+
+        size_t append_new_group_locked()
+        {
+            auto const group_index = group_count_.load(std::memory_order_relaxed);
+            auto* directory = directory_.load(std::memory_order_relaxed);
+
+            // grow the directory, readers keep using the old one safely until the hive is destroyed
+            if(!directory || group_index == directory->capacity)
+            {
+                auto const new_capacity = directory ? directory->capacity * 2 : size_t{ 8 };
+                auto new_directory = std::make_unique<group_directory>(group_directory
+                {
+                    new_capacity, std::make_unique<std::atomic<hive_group_type*>[]>(new_capacity)
+                });
+                for(size_t loop = 0; loop < group_index; ++loop)
+                {
+                    new_directory->groups[loop].store(directory->groups[loop].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                }
+                directory = new_directory.get();
+                directories_.push_back(std::move(new_directory));
+                directory_.store(directory, std::memory_order_release);
+            }
+
+            directory->groups[group_index].store(create_group(group_index * hive_group_capacity), std::memory_order_release);
+            group_count_.store(group_index + 1, std::memory_order_release);
+            return group_index;
+        }
+
+        hive_group_type* create_group(size_t first_global_index)
+        {
+            auto* ptr = hive_group_allocator{}.allocate(1);
+            return new (ptr) hive_group_type{ first_global_index };
+        }
+
+        void destroy_group(hive_group_type* group) noexcept
+        {
+            if(group)
+            {
+                group->~hive_group_type();
+                hive_group_allocator{}.deallocate(group, 1);
+            }
+        }
+    };
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Base/Types.h"
+#include <atomic>
+#include <assert.h>
+
+namespace punk
+{
+    // read-mostly open addressing table mapping integral keys to pointers
+    //  find   : wait-free, never blocks on writers or other readers
+    //  insert : writers must be serialized by the owner (e.g. under the registry lock)
+    // entries are never removed, a grown table is published atomically and superseded tables are kept alive
+    // until the table dies, so readers holding an old table stay valid
+    template <typename Key, typename Value>
+    class concurrent_lookup_table
+    {
+        static_assert(std::is_unsigned_v<Key>);
+        static_assert(std::is_pointer_v<Value>);
+
+    public:
+        using key_type = Key;
+        using value_type = Value;
+
+    private:
+        struct slot_t
+        {
+            // published after the key, a non-null value marks the slot occupied
+            std::atomic<key_type>   key;
+            std::atomic<value_type> value;
+        };
+
+        struct table_t
+        {
+            size_t                      mask;
+            std::atomic<size_t>         count;
+            std::unique_ptr<slot_t[]>   slots;
+        };
+
+        std::atomic<table_t*>                   table_;
+        std::vector<std::unique_ptr<table_t>>   tables_;
+
+    public:
+        explicit concurrent_lookup_table(size_t initial_capacity = 64)
+            : table_(nullptr)
+        {
+            publish_table(allocate_table(std::bit_ceil((std::max)(initial_capacity, size_t{ 8 }))));
+        }
+
+        concurrent_lookup_table(concurrent_lookup_table const&) = delete;
+        concurrent_lookup_table& operator=(concurrent_lookup_table const&) = delete;
+
+    public:
+        value_type find(key_type key) const noexcept
+        {
+            auto const* table = table_.load(std::memory_order_acquire);
+            for(auto index = hash_index(key, table->mask); ; index = (index + 1) & table->mask)
+            {
+                auto& slot = table->slots[index];
+                auto const value = slot.value.load(std::memory_order_acquire);
+                if(!value)
+                {
+                    return nullptr;
+                }
+                if(slot.key.load(std::memory_order_relaxed) == key)
+                {
+                    return value;
+                }
+            }
+        }
+
+        // returns the value already stored for key, or value when it was inserted
+        value_type insert(key_type key, value_type value)
+        {
+            assert(value);
+            auto* table = table_.load(std::memory_order_relaxed);
+
+            // keep the load factor under 1/2 so probes stay short
+            if((table->count.load(std::memory_order_relaxed) + 1) * 2 > table->mask + 1)
+            {
+                table = grow(table);
+            }
+
+            return insert_into(table, key, value);
+        }
+
+        size_t size() const noexcept
+        {
+            return table_.load(std::memory_order_acquire)->count.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static size_t hash_index(key_type key, size_t mask) noexcept
+        {
+            // fibonacci hashing spreads clustered keys
+            return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+        }
+
+        static value_type insert_into(table_t* table, key_type key, value_type value) noexcept
+        {
+            for(auto index = hash_index(key, table->mask); ; index = (index + 1) & table->mask)
+            {
+                auto& slot = table->slots[index];
+                auto const existing = slot.value.load(std::memory_order_relaxed);
+                if(!existing)
+                {
+                    slot.key.store(key, std::memory_order_relaxed);
+                    slot.value.store(value, std::memory_order_release);
+                    table->count.fetch_add(1, std::memory_order_relaxed);
+                    return value;
+                }
+                if(slot.key.load(std::memory_order_relaxed) == key)
+                {
+                    return existing;
+                }
+            }
+        }
+
+        std::unique_ptr<table_t> allocate_table(size_t capacity) const
+        {
+            assert(std::has_single_bit(capacity));
+            auto table = std::make_unique<table_t>();
+            table->mask = capacity - 1;
+            table->slots = std::make_unique<slot_t[]>(capacity);
+            return table;
+        }
+
+        table_t* grow(table_t const* table)
+        {
+            auto new_table = allocate_table((table->mask + 1) * 2);
+            for(size_t index = 0; index <= table->mask; ++index)
+            {
+                auto const value = table->slots[index].value.load(std::memory_order_relaxed);
+                if(value)
+                {
+                    insert_into(new_table.get(), table->slots[index].key.load(std::memory_order_relaxed), value);
+                }
+            }
+            return publish_table(std::move(new_table));
+        }
+
+        table_t* publish_table(std::unique_ptr<table_t> table)
+        {
+            auto* raw_table = table.get();
+            tables_.push_back(std::move(table));
+            table_.store(raw_table, std::memory_order_release);
+            return raw_table;
+        }
+    };
+}
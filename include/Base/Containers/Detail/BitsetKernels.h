@@ -0,0 +1,383 @@
+#pragma once
+
+#include "Base/Types.h"
+#include "Base/Utils/CpuFeatures.h"
+
+#define PUNK_BITSET_KERNELS_X86 PUNK_CPU_X86
+
+#if PUNK_BITSET_KERNELS_X86 && (defined(__clang__) || defined(__GNUC__))
+#define PUNK_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define PUNK_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#else
+#define PUNK_TARGET_SSE42
+#define PUNK_TARGET_AVX2
+#endif
+
+// word kernels used by dynamic_bitset bulk operations, the implementation is picked once at runtime
+namespace punk::detail
+{
+    enum class bitset_kernel_level : uint8_t
+    {
+        scalar = 0,
+        sse42 = 1,
+        avx2 = 2,
+    };
+
+    struct bitset_kernels
+    {
+        bitset_kernel_level level;
+        void(*and_assign)(uint64_t* dst, uint64_t const* src, size_t count);
+        void(*or_assign)(uint64_t* dst, uint64_t const* src, size_t count);
+        void(*xor_assign)(uint64_t* dst, uint64_t const* src, size_t count);
+        size_t(*popcount)(uint64_t const* src, size_t count);
+        bool(*any)(uint64_t const* src, size_t count);
+        // (lhs & rhs) == rhs, without a temporary
+        bool(*includes)(uint64_t const* lhs, uint64_t const* rhs, size_t count);
+        // (lhs & rhs) != 0, without a temporary
+        bool(*intersects)(uint64_t const* lhs, uint64_t const* rhs, size_t count);
+    };
+
+    // scalar fallback, also handles the tails of the vector kernels
+    namespace scalar_bitset_kernels
+    {
+        inline void and_assign(uint64_t* dst, uint64_t const* src, size_t count)
+        {
+            for(size_t loop = 0; loop < count; ++loop)
+            {
+                dst[loop] &= src[loop];
+            }
+        }
+
+        inline void or_assign(uint64_t* dst, uint64_t const* src, size_t count)
+        {
+            for(size_t loop = 0; loop < count; ++loop)
+            {
+                dst[loop] |= src[loop];
+            }
+        }
+
+        inline void xor_assign(uint64_t* dst, uint64_t const* src, size_t count)
+        {
+            for(size_t loop = 0; loop < count; ++loop)
+            {
+                dst[loop] ^= src[loop];
+            }
+        }
+
+        inline size_t popcount(uint64_t const* src, size_t count)
+        {
+            size_t result = 0;
+            for(size_t loop = 0; loop < count; ++loop)
+            {
+                result += static_cast<size_t>(std::popcount(src[loop]));
+            }
+            return result;
+        }
+
+        inline bool any(uint64_t const* src, size_t count)
+        {
+            for(size_t loop = 0; loop < count; ++loop)
+            {
+                if(src[loop] != 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        inline bool includes(uint64_t const* lhs, uint64_t const* rhs, size_t count)
+        {
+            for(size_t loop = 0; loop < count; ++loop)
+            {
+                if((lhs[loop] & rhs[loop]) != rhs[loop])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        inline bool intersects(uint64_t const* lhs, uint64_t const* rhs, size_t count)
+        {
+            for(size_t loop = 0; loop < count; ++loop)
+            {
+                if((lhs[loop] & rhs[loop]) != 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+#if PUNK_BITSET_KERNELS_X86
+    // 128 bit lanes, 2 words per step
+    namespace sse42_bitset_kernels
+    {
+        PUNK_TARGET_SSE42 inline void and_assign(uint64_t* dst, uint64_t const* src, size_t count)
+        {
+            size_t loop = 0;
+            for(; loop + 2 <= count; loop += 2)
+            {
+                auto const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + loop));
+                auto const b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + loop));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + loop), _mm_and_si128(a, b));
+            }
+            scalar_bitset_kernels::and_assign(dst + loop, src + loop, count - loop);
+        }
+
+        PUNK_TARGET_SSE42 inline void or_assign(uint64_t* dst, uint64_t const* src, size_t count)
+        {
+            size_t loop = 0;
+            for(; loop + 2 <= count; loop += 2)
+            {
+                auto const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + loop));
+                auto const b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + loop));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + loop), _mm_or_si128(a, b));
+            }
+            scalar_bitset_kernels::or_assign(dst + loop, src + loop, count - loop);
+        }
+
+        PUNK_TARGET_SSE42 inline void xor_assign(uint64_t* dst, uint64_t const* src, size_t count)
+        {
+            size_t loop = 0;
+            for(; loop + 2 <= count; loop += 2)
+            {
+                auto const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + loop));
+                auto const b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + loop));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + loop), _mm_xor_si128(a, b));
+            }
+            scalar_bitset_kernels::xor_assign(dst + loop, src + loop, count - loop);
+        }
+
+        // the hardware popcnt is the fastest option below avx2
+        PUNK_TARGET_SSE42 inline size_t popcount(uint64_t const* src, size_t count)
+        {
+            size_t result = 0;
+            for(size_t loop = 0; loop < count; ++loop)
+            {
+                result += static_cast<size_t>(_mm_popcnt_u64(src[loop]));
+            }
+            return result;
+        }
+
+        PUNK_TARGET_SSE42 inline bool any(uint64_t const* src, size_t count)
+        {
+            size_t loop = 0;
+            auto acc = _mm_setzero_si128();
+            for(; loop + 2 <= count; loop += 2)
+            {
+                acc = _mm_or_si128(acc, _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + loop)));
+            }
+            return !_mm_testz_si128(acc, acc) || scalar_bitset_kernels::any(src + loop, count - loop);
+        }
+
+        PUNK_TARGET_SSE42 inline bool includes(uint64_t const* lhs, uint64_t const* rhs, size_t count)
+        {
+            size_t loop = 0;
+            for(; loop + 2 <= count; loop += 2)
+            {
+                auto const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(lhs + loop));
+                auto const b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(rhs + loop));
+                // testc: (~a & b) == 0
+                if(!_mm_testc_si128(a, b))
+                {
+                    return false;
+                }
+            }
+            return scalar_bitset_kernels::includes(lhs + loop, rhs + loop, count - loop);
+        }
+
+        PUNK_TARGET_SSE42 inline bool intersects(uint64_t const* lhs, uint64_t const* rhs, size_t count)
+        {
+            size_t loop = 0;
+            for(; loop + 2 <= count; loop += 2)
+            {
+                auto const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(lhs + loop));
+                auto const b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(rhs + loop));
+                if(!_mm_testz_si128(a, b))
+                {
+                    return true;
+                }
+            }
+            return scalar_bitset_kernels::intersects(lhs + loop, rhs + loop, count - loop);
+        }
+    }
+
+    // 256 bit lanes, 4 words per step
+    namespace avx2_bitset_kernels
+    {
+        PUNK_TARGET_AVX2 inline void and_assign(uint64_t* dst, uint64_t const* src, size_t count)
+        {
+            size_t loop = 0;
+            for(; loop + 4 <= count; loop += 4)
+            {
+                auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + loop));
+                auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + loop));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + loop), _mm256_and_si256(a, b));
+            }
+            sse42_bitset_kernels::and_assign(dst + loop, src + loop, count - loop);
+        }
+
+        PUNK_TARGET_AVX2 inline void or_assign(uint64_t* dst, uint64_t const* src, size_t count)
+        {
+            size_t loop = 0;
+            for(; loop + 4 <= count; loop += 4)
+            {
+                auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + loop));
+                auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + loop));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + loop), _mm256_or_si256(a, b));
+            }
+            sse42_bitset_kernels::or_assign(dst + loop, src + loop, count - loop);
+        }
+
+        PUNK_TARGET_AVX2 inline void xor_assign(uint64_t* dst, uint64_t const* src, size_t count)
+        {
+            size_t loop = 0;
+            for(; loop + 4 <= count; loop += 4)
+            {
+                auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + loop));
+                auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + loop));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + loop), _mm256_xor_si256(a, b));
+            }
+            sse42_bitset_kernels::xor_assign(dst + loop, src + loop, count - loop);
+        }
+
+        // nibble lookup popcount (Mula), bytes are summed with sad against zero
+        PUNK_TARGET_AVX2 inline size_t popcount(uint64_t const* src, size_t count)
+        {
+            auto const lookup = _mm256_setr_epi8(
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+            auto const low_mask = _mm256_set1_epi8(0x0f);
+            auto acc = _mm256_setzero_si256();
+
+            size_t loop = 0;
+            for(; loop + 4 <= count; loop += 4)
+            {
+                auto const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + loop));
+                auto const lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+                auto const hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+                acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+            }
+
+            auto result = static_cast<size_t>(
+                _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+                _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3));
+            return result + sse42_bitset_kernels::popcount(src + loop, count - loop);
+        }
+
+        PUNK_TARGET_AVX2 inline bool any(uint64_t const* src, size_t count)
+        {
+            size_t loop = 0;
+            auto acc = _mm256_setzero_si256();
+            for(; loop + 4 <= count; loop += 4)
+            {
+                acc = _mm256_or_si256(acc, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + loop)));
+            }
+            return !_mm256_testz_si256(acc, acc) || sse42_bitset_kernels::any(src + loop, count - loop);
+        }
+
+        PUNK_TARGET_AVX2 inline bool includes(uint64_t const* lhs, uint64_t const* rhs, size_t count)
+        {
+            size_t loop = 0;
+            for(; loop + 4 <= count; loop += 4)
+            {
+                auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(lhs + loop));
+                auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(rhs + loop));
+                if(!_mm256_testc_si256(a, b))
+                {
+                    return false;
+                }
+            }
+            return sse42_bitset_kernels::includes(lhs + loop, rhs + loop, count - loop);
+        }
+
+        PUNK_TARGET_AVX2 inline bool intersects(uint64_t const* lhs, uint64_t const* rhs, size_t count)
+        {
+            size_t loop = 0;
+            for(; loop + 4 <= count; loop += 4)
+            {
+                auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(lhs + loop));
+                auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(rhs + loop));
+                if(!_mm256_testz_si256(a, b))
+                {
+                    return true;
+                }
+            }
+            return sse42_bitset_kernels::intersects(lhs + loop, rhs + loop, count - loop);
+        }
+    }
+#endif
+
+    inline bitset_kernel_level detect_bitset_kernel_level() noexcept
+    {
+#if PUNK_BITSET_KERNELS_X86
+        auto const& features = get_cpu_features();
+        bool const has_sse42 = features.sse42 && features.popcnt;
+        bool const has_avx2 = features.avx2;
+        if(has_avx2 && has_sse42)
+        {
+            return bitset_kernel_level::avx2;
+        }
+        if(has_sse42)
+        {
+            return bitset_kernel_level::sse42;
+        }
+#endif
+        return bitset_kernel_level::scalar;
+    }
+
+    inline bitset_kernels make_bitset_kernels(bitset_kernel_level level) noexcept
+    {
+        switch(level)
+        {
+#if PUNK_BITSET_KERNELS_X86
+        case bitset_kernel_level::avx2:
+            return
+            {
+                level,
+                avx2_bitset_kernels::and_assign,
+                avx2_bitset_kernels::or_assign,
+                avx2_bitset_kernels::xor_assign,
+                avx2_bitset_kernels::popcount,
+                avx2_bitset_kernels::any,
+                avx2_bitset_kernels::includes,
+                avx2_bitset_kernels::intersects,
+            };
+        case bitset_kernel_level::sse42:
+            return
+            {
+                level,
+                sse42_bitset_kernels::and_assign,
+                sse42_bitset_kernels::or_assign,
+                sse42_bitset_kernels::xor_assign,
+                sse42_bitset_kernels::popcount,
+                sse42_bitset_kernels::any,
+                sse42_bitset_kernels::includes,
+                sse42_bitset_kernels::intersects,
+            };
+#endif
+        default:
+            return
+            {
+                bitset_kernel_level::scalar,
+                scalar_bitset_kernels::and_assign,
+                scalar_bitset_kernels::or_assign,
+                scalar_bitset_kernels::xor_assign,
+                scalar_bitset_kernels::popcount,
+                scalar_bitset_kernels::any,
+                scalar_bitset_kernels::includes,
+                scalar_bitset_kernels::intersects,
+            };
+        }
+    }
+
+    // selected once per process
+    inline bitset_kernels const& get_bitset_kernels() noexcept
+    {
+        static bitset_kernels const kernels = make_bitset_kernels(detect_bitset_kernel_level());
+        return kernels;
+    }
+}
@@ -1,12 +1,16 @@
 #pragma once
 #include "Base/Reflection/TypeTraitsExt.h"
+#include "Base/Containers/Detail/BitsetKernels.h"
+#include "Base/Containers/SmallVector.h"
 #include <assert.h>
 #include <algorithm>
+#include <cstring>
 
 // re-implement dynamic bitset
 namespace punk
 {
-    template <typename Block = uint64_t, typename Allocator = std::allocator<Block>>
+    // Storage is any contiguous vector-like container of blocks, see small_bitset for the inline variant
+    template <typename Block = uint64_t, typename Allocator = std::allocator<Block>, typename Storage = std::vector<Block, Allocator>>
     class dynamic_bitset
     {
         static_assert(std::conjunction_v<std::negation<is_bool<Block>>, std::is_unsigned<Block>>);
@@ -14,7 +18,7 @@ namespace punk
     public: // export types
         using block_type = Block;
         using allocator_type = Allocator;
-        using storage_type = std::vector<block_type, allocator_type>;
+        using storage_type = Storage;
         using block_width_type = typename storage_type::size_type;
         using size_type = size_t;
 
@@ -23,6 +27,8 @@ namespace punk
         static constexpr size_type npos = (std::numeric_limits<size_type>::max)();
         static constexpr block_type ones = (std::numeric_limits<block_type>::max)();
         static constexpr block_type zeros = 0;
+        // bulk operations dispatch to the simd word kernels when blocks are 64 bit
+        static constexpr bool use_word_kernels = std::is_same_v<block_type, uint64_t>;
 
     public: // static functions
         template <typename CharType>
@@ -65,13 +71,16 @@ namespace punk
 
         static constexpr block_type bit_mask(size_type pos) noexcept
         {
-            return block_type{ 1 } >> bit_index(pos);
+            return static_cast<block_type>(block_type{ 1 } << bit_index(pos));
         }
 
+        // mask of bits [begin, end] inside one block
         static constexpr block_type bit_mask(size_type begin, size_type end) noexcept
         {
-            auto mask = end == bits_per_block - 1 ? ones :
-                (block_type{ 1 } << (end + 1)) - 1;
+            auto const high = end == bits_per_block - 1 ? ones :
+                static_cast<block_type>((block_type{ 1 } << (end + 1)) - 1);
+            auto const low = static_cast<block_type>((block_type{ 1 } << begin) - 1);
+            return static_cast<block_type>(high & ~low);
         }
 
         static constexpr size_type calc_num_blocks(size_type num_bits) noexcept
@@ -124,6 +133,7 @@ namespace punk
             : num_bits_(num_bits)
             , storage_(calc_num_blocks(num_bits), set ? ones : zeros, alloc)
         {
+            zero_unused_bits();
         }
 
         // construct with unsigned integer
@@ -171,7 +181,7 @@ namespace punk
         // block & block mask as reference type
         class reference
         {
-            friend class dynamic_bitset<Block, Allocator>;
+            friend class dynamic_bitset;
             reference(block_type& block, block_width_type pos) noexcept
                 : block_(block)
                 , mask_(block_type{ 1 } << pos)
@@ -250,7 +260,7 @@ namespace punk
 
             void reset() noexcept
             {
-                block_ &= mask_;
+                block_ &= ~mask_;
             }
 
             void flip_impl() noexcept
@@ -267,6 +277,82 @@ namespace punk
         // bool as const_reference type
         using const_reference = bool;
 
+        // forward iterator over the positions of set bits, one countr_zero per step
+        class set_bit_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = size_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = size_type;
+
+        private:
+            block_type const*   blocks_;
+            size_type           block_count_;
+            size_type           block_idx_;
+            block_type          remaining_;
+
+        public:
+            set_bit_iterator() noexcept
+                : blocks_(nullptr)
+                , block_count_(0)
+                , block_idx_(0)
+                , remaining_(zeros)
+            {
+            }
+
+            set_bit_iterator(block_type const* blocks, size_type block_count) noexcept
+                : blocks_(blocks)
+                , block_count_(block_count)
+                , block_idx_(0)
+                , remaining_(block_count > 0 ? blocks[0] : zeros)
+            {
+                skip_empty_blocks();
+            }
+
+            size_type operator*() const noexcept
+            {
+                assert(remaining_ != zeros);
+                return block_idx_ * bits_per_block + static_cast<size_type>(std::countr_zero(remaining_));
+            }
+
+            set_bit_iterator& operator++() noexcept
+            {
+                // clear the lowest set bit
+                remaining_ &= static_cast<block_type>(remaining_ - 1);
+                skip_empty_blocks();
+                return *this;
+            }
+
+            set_bit_iterator operator++(int) noexcept
+            {
+                auto temp = *this;
+                ++*this;
+                return temp;
+            }
+
+            friend bool operator==(set_bit_iterator const& lhs, set_bit_iterator const& rhs) noexcept
+            {
+                return lhs.block_idx_ == rhs.block_idx_ && lhs.remaining_ == rhs.remaining_;
+            }
+
+            friend bool operator==(set_bit_iterator const& itr, std::default_sentinel_t) noexcept
+            {
+                return itr.block_idx_ >= itr.block_count_;
+            }
+
+        private:
+            void skip_empty_blocks() noexcept
+            {
+                while(remaining_ == zeros && ++block_idx_ < block_count_)
+                {
+                    remaining_ = blocks_[block_idx_];
+                }
+            }
+        };
+        using set_bit_range = std::ranges::subrange<set_bit_iterator, std::default_sentinel_t>;
+
     public: // member access
         reference operator[](size_type pos)
         {
@@ -275,7 +361,7 @@ namespace punk
                 throw std::out_of_range{ "access out of range." };
             }
 
-            auto const block_idx = bit_index(pos);
+            auto const block_idx = block_index(pos);
             auto const bit_idx = bit_index(pos);
             return reference{ storage_[block_idx], bit_idx };
         }
@@ -321,7 +407,14 @@ namespace punk
 
         bool any() const noexcept
         {
-            return std::ranges::any_of(storage_, [](auto const elem) { return elem != zeros; });
+            if constexpr(use_word_kernels)
+            {
+                return detail::get_bitset_kernels().any(storage_.data(), storage_.size());
+            }
+            else
+            {
+                return std::ranges::any_of(storage_, [](auto const elem) { return elem != zeros; });
+            }
         }
 
         bool none() const noexcept
@@ -336,6 +429,12 @@ namespace punk
                 return 0;
             }
 
+            // unused bits are always zero, so whole blocks can be counted
+            if constexpr(use_word_kernels)
+            {
+                return detail::get_bitset_kernels().popcount(storage_.data(), storage_.size());
+            }
+
             auto result = std::reduce(storage_.cbegin(), storage_.cend() - 1, size_type{ 0 },
                 [](size_type acc, block_type elem)
                 {
@@ -380,6 +479,44 @@ namespace punk
                 : find_from(blk + 1);
         }
 
+        // e.g. for(auto pos : bits.set_bits()) {...}
+        set_bit_range set_bits() const noexcept
+        {
+            return { set_bit_iterator{ storage_.data(), storage_.size() }, std::default_sentinel };
+        }
+
+        // invoke func(pos) for every set bit in ascending order, a bool returning func stops the walk on false
+        template <typename Func> requires(std::invocable<Func&, size_type>)
+        void for_each_set(Func&& func) const
+        {
+            auto const block_count = storage_.size();
+            auto const* blocks = storage_.data();
+
+            // 4 blocks per step, so sparse masks skip zero runs with a single test
+            size_type block_idx = 0;
+            for(; block_idx + 4 <= block_count; block_idx += 4)
+            {
+                if((blocks[block_idx] | blocks[block_idx + 1] | blocks[block_idx + 2] | blocks[block_idx + 3]) == zeros)
+                {
+                    continue;
+                }
+                for(size_type loop = block_idx; loop < block_idx + 4; ++loop)
+                {
+                    if(!for_each_set_in_block(blocks[loop], loop * bits_per_block, func))
+                    {
+                        return;
+                    }
+                }
+            }
+            for(; block_idx < block_count; ++block_idx)
+            {
+                if(!for_each_set_in_block(blocks[block_idx], block_idx * bits_per_block, func))
+                {
+                    return;
+                }
+            }
+        }
+
         block_type* data() noexcept
         {
             return storage_.data();
@@ -416,20 +553,15 @@ namespace punk
                 storage_.resize(new_block_count, value ? ones : zeros);
             }
 
+            // the unused bits of the old last block are zero, only set them when growing with ones
             auto const bit_idx = bit_index(num_bits_);
-            if(num_bits > num_bits_ && bit_idx > 0)
+            if(value && num_bits > num_bits_ && bit_idx > 0 && block_count > 0)
             {
-                auto const mask = (block_type{ 1 } << bit_idx) - 1;
-                if(value)
-                {
-                    storage_[block_count - 1] |= ~mask;
-                }
-                else
-                {
-                    storage_[block_count - 1] &= mask;
-                }
+                auto const mask = static_cast<block_type>((block_type{ 1 } << bit_idx) - 1);
+                storage_[block_count - 1] |= static_cast<block_type>(~mask);
             }
             num_bits_ = num_bits;
+            zero_unused_bits();
         }
 
         void swap(dynamic_bitset& other) noexcept
@@ -491,9 +623,16 @@ namespace punk
             if(&other != this)
             {
                 assert(other.size() == size());
-                for(block_width_type loop = 0; loop < other.block_size(); ++loop)
+                if constexpr(use_word_kernels)
                 {
-                    storage_[loop] &= other.storage_[loop];
+                    detail::get_bitset_kernels().and_assign(storage_.data(), other.storage_.data(), storage_.size());
+                }
+                else
+                {
+                    for(block_width_type loop = 0; loop < other.block_size(); ++loop)
+                    {
+                        storage_[loop] &= other.storage_[loop];
+                    }
                 }
             }
             return *this;
@@ -505,9 +644,16 @@ namespace punk
             if(&other != this)
             {
                 assert(other.size() == size());
-                for(block_width_type loop = 0; loop < other.block_size(); ++loop)
+                if constexpr(use_word_kernels)
                 {
-                    storage_[loop] |= other.storage_[loop];
+                    detail::get_bitset_kernels().or_assign(storage_.data(), other.storage_.data(), storage_.size());
+                }
+                else
+                {
+                    for(block_width_type loop = 0; loop < other.block_size(); ++loop)
+                    {
+                        storage_[loop] |= other.storage_[loop];
+                    }
                 }
             }
             return *this;
@@ -519,9 +665,16 @@ namespace punk
             if(&other != this)
             {
                 assert(other.size() == size());
-                for(block_width_type loop = 0; loop < other.block_size(); ++loop)
+                if constexpr(use_word_kernels)
+                {
+                    detail::get_bitset_kernels().xor_assign(storage_.data(), other.storage_.data(), storage_.size());
+                }
+                else
                 {
-                    storage_[loop] ^= other.storage_[loop];
+                    for(block_width_type loop = 0; loop < other.block_size(); ++loop)
+                    {
+                        storage_[loop] ^= other.storage_[loop];
+                    }
                 }
             }
             return *this;
@@ -533,15 +686,68 @@ namespace punk
             return result.flip();
         }
 
+        // moves bit i to bit i + n, bits shifted past size() are dropped
         dynamic_bitset& operator<<=(size_type n)
         {
-            // TODO ...
+            if(n >= num_bits_)
+            {
+                return reset();
+            }
+
+            auto const block_shift = block_index(n);
+            auto const bit_shift = bit_index(n);
+            auto const last = block_size() - 1;
+            if(bit_shift == 0)
+            {
+                for(size_type loop = last + 1; loop-- > block_shift;)
+                {
+                    storage_[loop] = storage_[loop - block_shift];
+                }
+            }
+            else
+            {
+                auto const carry_shift = bits_per_block - bit_shift;
+                for(size_type loop = last; loop > block_shift; --loop)
+                {
+                    storage_[loop] = static_cast<block_type>(
+                        (storage_[loop - block_shift] << bit_shift) | (storage_[loop - block_shift - 1] >> carry_shift));
+                }
+                storage_[block_shift] = static_cast<block_type>(storage_[0] << bit_shift);
+            }
+            std::fill_n(storage_.begin(), block_shift, zeros);
+            zero_unused_bits();
             return *this;
         }
 
+        // moves bit i to bit i - n, the vacated high bits become zero
         dynamic_bitset& operator>>=(size_type n)
         {
-            // TODO ...
+            if(n >= num_bits_)
+            {
+                return reset();
+            }
+
+            auto const block_shift = block_index(n);
+            auto const bit_shift = bit_index(n);
+            auto const last = block_size() - 1;
+            if(bit_shift == 0)
+            {
+                for(size_type loop = 0; loop + block_shift <= last; ++loop)
+                {
+                    storage_[loop] = storage_[loop + block_shift];
+                }
+            }
+            else
+            {
+                auto const carry_shift = bits_per_block - bit_shift;
+                for(size_type loop = 0; loop + block_shift < last; ++loop)
+                {
+                    storage_[loop] = static_cast<block_type>(
+                        (storage_[loop + block_shift] >> bit_shift) | (storage_[loop + block_shift + 1] << carry_shift));
+                }
+                storage_[last - block_shift] = static_cast<block_type>(storage_[last] >> bit_shift);
+            }
+            std::fill(storage_.begin() + (last - block_shift + 1), storage_.end(), zeros);
             return *this;
         }
 
@@ -558,7 +764,8 @@ namespace punk
 
         dynamic_bitset& set() noexcept
         {
-            std::ranges::fill_n(storage_, storage_.size(), ones);
+            std::ranges::fill(storage_, ones);
+            zero_unused_bits();
             return *this;
         }
         dynamic_bitset& set(size_type pos, bool value = true)
@@ -589,7 +796,7 @@ namespace punk
         /// reset
         dynamic_bitset& reset() noexcept
         {
-            std::ranges::fill_n(storage_, storage_.size(), zeros);
+            std::ranges::fill(storage_, zeros);
             return *this;
         }
         dynamic_bitset& reset(size_type pos)
@@ -614,6 +821,7 @@ namespace punk
             {
                 elem = ~elem;
             }
+            zero_unused_bits();
             return *this;
         }
         dynamic_bitset& flip(size_type pos)
@@ -631,6 +839,55 @@ namespace punk
             return *this;
         }
 
+    public: // fused queries, no temporaries
+        // (*this & other) != 0
+        bool intersects(dynamic_bitset const& other) const noexcept
+        {
+            auto const count = (std::min)(block_size(), other.block_size());
+            if constexpr(use_word_kernels)
+            {
+                return detail::get_bitset_kernels().intersects(storage_.data(), other.storage_.data(), count);
+            }
+            else
+            {
+                for(block_width_type loop = 0; loop < count; ++loop)
+                {
+                    if((storage_[loop] & other.storage_[loop]) != zeros)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+        }
+
+        // (*this & other) == *this
+        bool is_subset_of(dynamic_bitset const& other) const noexcept
+        {
+            assert(other.size() == size());
+            if constexpr(use_word_kernels)
+            {
+                return detail::get_bitset_kernels().includes(other.storage_.data(), storage_.data(), storage_.size());
+            }
+            else
+            {
+                for(block_width_type loop = 0; loop < block_size(); ++loop)
+                {
+                    if((storage_[loop] & other.storage_[loop]) != storage_[loop])
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        }
+
+        // (*this & other) == other
+        bool includes(dynamic_bitset const& other) const noexcept
+        {
+            return other.is_subset_of(*this);
+        }
+
     public: // conversions
         template <typename StrType, typename CharType = typename StrType::value_type>
         void to_string(StrType& str, CharType zero = dynamic_bitset::zero<CharType>(), CharType one = dynamic_bitset::one<CharType>()) const
@@ -700,6 +957,16 @@ namespace punk
             }
         }
         
+        // keeps the bits beyond size() zero, bulk operations rely on it
+        void zero_unused_bits() noexcept
+        {
+            auto const bit_idx = bit_index(num_bits_);
+            if(bit_idx > 0 && !storage_.empty())
+            {
+                storage_.back() &= static_cast<block_type>((block_type{ 1 } << bit_idx) - 1);
+            }
+        }
+
         bool test_impl(size_type pos) const
         {
             auto const block_idx = block_index(pos);
@@ -743,6 +1010,29 @@ namespace punk
             return result;
         }
 
+        template <typename Func>
+        static bool for_each_set_in_block(block_type block, size_type base, Func& func)
+        {
+            while(block != zeros)
+            {
+                auto const pos = base + static_cast<size_type>(std::countr_zero(block));
+                block &= static_cast<block_type>(block - 1);
+                if constexpr(std::is_same_v<std::invoke_result_t<Func&, size_type>, bool>)
+                {
+                    if(!func(pos))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    func(pos);
+                }
+            }
+            return true;
+        }
+
+        // first set bit at or after block index pos
         size_type find_from(size_t pos) const
         {
             size_type i = pos;
@@ -763,43 +1053,52 @@ namespace punk
         }
 
     public: // friends
-        template <typename Block1, typename Allocator1>
-        friend bool operator==(dynamic_bitset<Block1, Allocator1> const& lhs, dynamic_bitset<Block1, Allocator1> const& rhs) noexcept
+        friend bool operator==(dynamic_bitset const& lhs, dynamic_bitset const& rhs) noexcept
         {
-            return lhs.num_bits_ == rhs.num_bits_ && std::memcmp(lhs.data(), rhs.data(), lhs.num_bits_ / sizeof(uint8_t));
+            return lhs.num_bits_ == rhs.num_bits_ && std::equal(lhs.storage_.begin(), lhs.storage_.end(), rhs.storage_.begin());
         }
 
-        template <typename Block1, typename Allocator1>
-        friend bool operator!=(dynamic_bitset<Block1, Allocator1> const& lhs, dynamic_bitset<Block1, Allocator1> const& rhs) noexcept
+        friend bool operator!=(dynamic_bitset const& lhs, dynamic_bitset const& rhs) noexcept
         {
             return !(lhs == rhs);
         }
 
-        template <typename Block1, typename Allocator1>
-        friend dynamic_bitset<Block1, Allocator1> operator&(dynamic_bitset<Block1, Allocator1> const& lhs, dynamic_bitset<Block1, Allocator1> const& rhs)
+        friend dynamic_bitset operator&(dynamic_bitset const& lhs, dynamic_bitset const& rhs)
         {
-            dynamic_bitset<Block1, Allocator1> result{ lhs };
+            dynamic_bitset result{ lhs };
             return result &= rhs;
         }
 
-        template <typename Block1, typename Allocator1>
-        friend dynamic_bitset<Block1, Allocator1> operator|(dynamic_bitset<Block1, Allocator1> const& lhs, dynamic_bitset<Block1, Allocator1> const& rhs)
+        friend dynamic_bitset operator|(dynamic_bitset const& lhs, dynamic_bitset const& rhs)
         {
-            dynamic_bitset<Block1, Allocator1> result{ lhs };
+            dynamic_bitset result{ lhs };
             return result |= rhs;
         }
 
-        template <typename Block1, typename Allocator1>
-        friend dynamic_bitset<Block1, Allocator1> operator^(dynamic_bitset<Block1, Allocator1> const& lhs, dynamic_bitset<Block1, Allocator1> const& rhs)
+        friend dynamic_bitset operator^(dynamic_bitset const& lhs, dynamic_bitset const& rhs)
         {
-            dynamic_bitset<Block1, Allocator1> result{ lhs };
+            dynamic_bitset result{ lhs };
             return result ^= rhs;
         }
 
-        template <typename Block1, typename Allocator1>
-        void swap(dynamic_bitset<Block1, Allocator1>& lhs, dynamic_bitset<Block1, Allocator1>& rhs)
+        friend bool intersects(dynamic_bitset const& lhs, dynamic_bitset const& rhs) noexcept
+        {
+            return lhs.intersects(rhs);
+        }
+
+        // (lhs & rhs) == rhs
+        friend bool includes(dynamic_bitset const& lhs, dynamic_bitset const& rhs) noexcept
+        {
+            return lhs.includes(rhs);
+        }
+
+        friend void swap(dynamic_bitset& lhs, dynamic_bitset& rhs)
         {
             lhs.swap(rhs);
         }
     };
+
+    // keeps up to InlineBlocks blocks inline, e.g. small_bitset<4> holds 256 bits without touching the heap
+    template <size_t InlineBlocks, typename Block = uint64_t, typename Allocator = std::allocator<Block>>
+    using small_bitset = dynamic_bitset<Block, Allocator, small_vector<Block, InlineBlocks, Allocator>>;
 }
\ No newline at end of file
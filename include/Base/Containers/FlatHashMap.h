@@ -0,0 +1,243 @@
+#pragma once
+
+#include "Base/Types.h"
+#include <optional>
+#include <assert.h>
+
+namespace punk
+{
+    // open addressing hash map with linear probing, keyed by 64-bit hashes
+    //  the hashes live in their own contiguous array, a probe only touches an entry when its full hash matches
+    //  and the key comparison then rules out collisions, so two keys never alias
+    //  Hash & KeyEqual may be transparent, lookups accept any key type they are callable with
+    //  erase shifts the following entries back, so there are no tombstones
+    template <typename Key, typename Value, typename Hash, typename KeyEqual = std::equal_to<>>
+    class flat_hash_map
+    {
+    public: // export types
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+        using size_type = size_t;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+
+    public: // export constant
+        static constexpr size_type min_capacity = 8;
+        static constexpr size_type npos = (std::numeric_limits<size_type>::max)();
+
+    private:
+        // 0 marks an empty slot
+        std::vector<uint64_t>                   hashes_;
+        std::vector<std::optional<value_type>>  entries_;
+        size_type                               size_ = 0;
+        uint32_t                                shift_ = 64;
+        [[no_unique_address]] hasher            hash_;
+        [[no_unique_address]] key_equal         equal_;
+
+    public:
+        flat_hash_map() = default;
+
+        explicit flat_hash_map(size_type capacity)
+        {
+            reserve(capacity);
+        }
+
+    public: // capacity
+        size_type size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+        size_type capacity() const noexcept { return hashes_.size(); }
+
+        void reserve(size_type count)
+        {
+            // load factor stays under 7/8
+            auto const required = std::bit_ceil((std::max)(min_capacity, count + count / 7 + 1));
+            if(required > capacity())
+            {
+                rehash(required);
+            }
+        }
+
+        void clear() noexcept
+        {
+            std::ranges::fill(hashes_, uint64_t{ 0 });
+            std::ranges::for_each(entries_, [](auto& entry) { entry.reset(); });
+            size_ = 0;
+        }
+
+    public: // lookup
+        template <typename K>
+        value_type* find(K const& key)
+        {
+            return find(key, hash_key(key));
+        }
+
+        template <typename K>
+        value_type const* find(K const& key) const
+        {
+            return const_cast<flat_hash_map*>(this)->find(key);
+        }
+
+        // lookup with a hash the caller already computed with the same hasher
+        template <typename K>
+        value_type* find(K const& key, uint64_t hash)
+        {
+            return find_if(hash, [&](key_type const& stored_key) { return equal_(stored_key, key); });
+        }
+
+        // first entry with the given hash accepted by pred
+        template <typename Pred>
+        value_type* find_if(uint64_t hash, Pred&& pred)
+        {
+            auto const index = find_index_if(hash, std::forward<Pred>(pred));
+            return index != npos ? &*entries_[index] : nullptr;
+        }
+
+        template <typename K>
+        bool contains(K const& key) const
+        {
+            return find(key) != nullptr;
+        }
+
+        template <typename Func>
+        void for_each(Func&& func) const
+        {
+            for(auto const& entry : entries_)
+            {
+                if(entry)
+                {
+                    func(entry->first, entry->second);
+                }
+            }
+        }
+
+    public: // modifiers
+        // returns the entry for key & whether it was inserted, the mapped value is only constructed on insertion
+        template <typename K, typename ... Args>
+        std::pair<value_type*, bool> try_emplace(K&& key, Args&& ... args)
+        {
+            auto const hash = hash_key(key);
+            if(auto* entry = find(key, hash))
+            {
+                return { entry, false };
+            }
+
+            reserve(size_ + 1);
+            auto const index = insert_index(normalize_hash(hash));
+            hashes_[index] = normalize_hash(hash);
+            entries_[index].emplace(std::piecewise_construct,
+                std::forward_as_tuple(std::forward<K>(key)),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+            ++size_;
+            return { &*entries_[index], true };
+        }
+
+        template <typename K>
+        bool erase(K const& key)
+        {
+            return erase_if(hash_key(key), [&](key_type const& stored_key) { return equal_(stored_key, key); });
+        }
+
+        // erase the first entry with the given hash accepted by pred
+        template <typename Pred>
+        bool erase_if(uint64_t hash, Pred&& pred)
+        {
+            auto const index = find_index_if(hash, std::forward<Pred>(pred));
+            if(index == npos)
+            {
+                return false;
+            }
+            erase_at(index);
+            return true;
+        }
+
+    private:
+        template <typename K>
+        uint64_t hash_key(K const& key) const
+        {
+            return static_cast<uint64_t>(hash_(key));
+        }
+
+        static constexpr uint64_t normalize_hash(uint64_t hash) noexcept
+        {
+            return hash == 0 ? 1 : hash;
+        }
+
+        template <typename Pred>
+        size_type find_index_if(uint64_t hash, Pred&& pred) const
+        {
+            if(empty())
+            {
+                return npos;
+            }
+
+            hash = normalize_hash(hash);
+            for(auto index = home_index(hash); hashes_[index] != 0; index = next_index(index))
+            {
+                if(hashes_[index] == hash && pred(entries_[index]->first))
+                {
+                    return index;
+                }
+            }
+            return npos;
+        }
+
+        size_type home_index(uint64_t hash) const noexcept
+        {
+            // top bits, the hashes are expected to be well mixed
+            return static_cast<size_type>(hash >> shift_);
+        }
+
+        size_type next_index(size_type index) const noexcept
+        {
+            return (index + 1) & (capacity() - 1);
+        }
+
+        size_type insert_index(uint64_t hash) const noexcept
+        {
+            auto index = home_index(hash);
+            while(hashes_[index] != 0)
+            {
+                index = next_index(index);
+            }
+            return index;
+        }
+
+        void erase_at(size_type hole)
+        {
+            auto const mask = capacity() - 1;
+            for(auto index = next_index(hole); hashes_[index] != 0; index = next_index(index))
+            {
+                // shift back every entry whose probe sequence passes over the hole
+                auto const home = home_index(hashes_[index]);
+                if(((index - home) & mask) >= ((index - hole) & mask))
+                {
+                    hashes_[hole] = hashes_[index];
+                    entries_[hole] = std::move(entries_[index]);
+                    hole = index;
+                }
+            }
+            hashes_[hole] = 0;
+            entries_[hole].reset();
+            --size_;
+        }
+
+        void rehash(size_type new_capacity)
+        {
+            assert(std::has_single_bit(new_capacity));
+            auto old_hashes = std::exchange(hashes_, std::vector<uint64_t>(new_capacity, 0));
+            auto old_entries = std::exchange(entries_, std::vector<std::optional<value_type>>(new_capacity));
+            shift_ = 64 - static_cast<uint32_t>(std::countr_zero(new_capacity));
+
+            for(size_type index = 0; index < old_hashes.size(); ++index)
+            {
+                if(old_hashes[index] != 0)
+                {
+                    auto const new_index = insert_index(old_hashes[index]);
+                    hashes_[new_index] = old_hashes[index];
+                    entries_[new_index] = std::move(old_entries[index]);
+                }
+            }
+        }
+    };
+}
@@ -33,10 +33,12 @@ namespace punk
         };
         using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<element_storage>;
         using storage_type = std::vector<element_storage, allocator_type>;
+        // group occupancy bits live inline in the group
+        using storage_bits_type = small_bitset<(PUNK_HIVE_GROUP_CAPACITY + 63) / 64>;
 
     private:
         storage_type        storage_;
-        dynamic_bitset<>    storage_bits_;
+        storage_bits_type   storage_bits_;
         size_t              first_available_index_;
         size_t              available_element_count_;
         size_t const        first_global_index_;
@@ -0,0 +1,260 @@
+#pragma once
+
+#include "Base/Containers/DynamicBitset.h"
+
+namespace punk
+{
+    // bitset with a succinct rank/select index
+    //  rank(pos)   : number of set bits in [0, pos), O(1)
+    //  select(nth) : position of the nth (0-based) set bit, a sampled hint + a short search
+    // every write keeps the whole index exact, queries stay O(1) & never mutate
+    //  a write adds to the in-superblock counts & the prefix of every following superblock, O(size / 512) adds
+    //  only the select samples sitting on a shifted superblock boundary are searched again, usually none
+    // bulk changes are cheaper through resize or the bitset constructor, which rebuild the index once
+    template <typename Bitset = dynamic_bitset<>>
+    class rank_select_bitset
+    {
+    public: // export types
+        using bitset_type = Bitset;
+        using block_type = typename bitset_type::block_type;
+        using size_type = typename bitset_type::size_type;
+
+        static_assert(std::is_same_v<block_type, uint64_t>);
+
+    public: // export constant
+        static constexpr size_type npos = bitset_type::npos;
+        static constexpr size_type bits_per_block = bitset_type::bits_per_block;
+        static constexpr size_type blocks_per_superblock = 8;
+        static constexpr size_type bits_per_superblock = bits_per_block * blocks_per_superblock;
+        static constexpr size_type select_sample_rate = bits_per_superblock;
+
+    private:
+        bitset_type                     bits_;
+        // set bits before each superblock
+        std::vector<uint64_t>           super_ranks_;
+        // set bits before each block, relative to its superblock
+        std::vector<uint16_t>           block_ranks_;
+        // superblock holding every select_sample_rate-th set bit
+        std::vector<uint32_t>           select_hints_;
+
+    public:
+        rank_select_bitset()
+        {
+            rebuild_index();
+        }
+
+        explicit rank_select_bitset(size_type num_bits, bool value = false)
+            : bits_(num_bits, value)
+        {
+            rebuild_index();
+        }
+
+        explicit rank_select_bitset(bitset_type bits)
+            : bits_(std::move(bits))
+        {
+            rebuild_index();
+        }
+
+    public: // bitset access
+        bitset_type const& bits() const noexcept { return bits_; }
+        size_type size() const noexcept { return bits_.size(); }
+        bool empty() const noexcept { return bits_.empty(); }
+        bool test(size_type pos) const { return bits_.test(pos); }
+
+        size_type count() const noexcept
+        {
+            return empty() ? 0 : rank(size());
+        }
+
+    public: // modifiers
+        rank_select_bitset& set(size_type pos, bool value = true)
+        {
+            if(bits_.test(pos) != value)
+            {
+                bits_.set(pos, value);
+                adjust_block_ranks(pos, value ? 1 : -1);
+            }
+            return *this;
+        }
+
+        rank_select_bitset& reset(size_type pos)
+        {
+            return set(pos, false);
+        }
+
+        rank_select_bitset& flip(size_type pos)
+        {
+            return set(pos, !bits_.test(pos));
+        }
+
+        void resize(size_type num_bits, bool value = false)
+        {
+            bits_.resize(num_bits, value);
+            rebuild_index();
+        }
+
+        void push_back(bool value)
+        {
+            resize(size() + 1, value);
+        }
+
+    public: // queries
+        size_type rank(size_type pos) const
+        {
+            assert(pos <= size());
+
+            auto const block_idx = pos / bits_per_block;
+            auto const bit_idx = pos % bits_per_block;
+            if(block_idx >= bits_.block_size())
+            {
+                return static_cast<size_type>(super_ranks_.back());
+            }
+
+            auto const word = bits_.data()[block_idx] & ((block_type{ 1 } << bit_idx) - 1);
+            return static_cast<size_type>(super_ranks_[block_idx / blocks_per_superblock] + block_ranks_[block_idx])
+                + static_cast<size_type>(std::popcount(word));
+        }
+
+        size_type select(size_type nth) const
+        {
+            if(super_ranks_.empty() || nth >= super_ranks_.back())
+            {
+                return npos;
+            }
+
+            // the hints bound the superblock search to one sample interval
+            auto const sample_idx = nth / select_sample_rate;
+            auto const first_super = select_hints_[sample_idx];
+            auto const last_super = sample_idx + 1 < select_hints_.size() ? select_hints_[sample_idx + 1] + 1 : super_ranks_.size() - 1;
+            auto const super_itr = std::upper_bound(super_ranks_.begin() + first_super, super_ranks_.begin() + last_super, static_cast<uint64_t>(nth));
+            auto const super_idx = static_cast<size_type>(std::distance(super_ranks_.begin(), super_itr)) - 1;
+
+            // at most 8 blocks to look at
+            auto remaining = static_cast<size_type>(nth - super_ranks_[super_idx]);
+            auto const first_block = super_idx * blocks_per_superblock;
+            auto const last_block = (std::min)(first_block + blocks_per_superblock, static_cast<size_type>(bits_.block_size()));
+            auto block_idx = first_block;
+            while(block_idx + 1 < last_block && block_ranks_[block_idx + 1] <= remaining)
+            {
+                ++block_idx;
+            }
+            remaining -= block_ranks_[block_idx];
+            return block_idx * bits_per_block + select_in_word(bits_.data()[block_idx], remaining);
+        }
+
+    private:
+        static size_type select_in_word(block_type word, size_type nth) noexcept
+        {
+            // skip whole bytes, then clear the remaining low bits
+            size_type base = 0;
+            for(auto byte_count = static_cast<size_type>(std::popcount(word & 0xffu)); byte_count <= nth; byte_count = static_cast<size_type>(std::popcount(word & 0xffu)))
+            {
+                nth -= byte_count;
+                word >>= 8;
+                base += 8;
+            }
+            for(; nth > 0; --nth)
+            {
+                word &= word - 1;
+            }
+            return base + static_cast<size_type>(std::countr_zero(word));
+        }
+
+        uint64_t superblock_popcount(size_type super_idx) const noexcept
+        {
+            auto const last_block = (std::min)((super_idx + 1) * blocks_per_superblock, static_cast<size_type>(bits_.block_size())) - 1;
+            return block_ranks_[last_block] + static_cast<uint64_t>(std::popcount(bits_.data()[last_block]));
+        }
+
+        void adjust_block_ranks(size_type pos, int delta)
+        {
+            auto const block_idx = pos / bits_per_block;
+            auto const super_idx = block_idx / blocks_per_superblock;
+            auto const last_block = (std::min)((super_idx + 1) * blocks_per_superblock, static_cast<size_type>(bits_.block_size()));
+            for(auto loop = block_idx + 1; loop < last_block; ++loop)
+            {
+                block_ranks_[loop] = static_cast<uint16_t>(block_ranks_[loop] + delta);
+            }
+
+            // one add per following superblock, a tight loop over a contiguous array
+            for(auto loop = super_idx + 1; loop < super_ranks_.size(); ++loop)
+            {
+                super_ranks_[loop] = static_cast<uint64_t>(static_cast<int64_t>(super_ranks_[loop]) + delta);
+            }
+            adjust_select_hints(super_idx, delta);
+        }
+
+        // a sample only moves when a following superblock starts exactly at its rank before or after the write
+        // & the sample count only changes when the total crosses a multiple of the sample rate
+        void adjust_select_hints(size_type super_idx, int delta)
+        {
+            auto const total = super_ranks_.back();
+            if(delta > 0 && total % select_sample_rate == 0)
+            {
+                select_hints_.push_back(0);
+                repair_select_hint(select_hints_.size() - 1);
+            }
+            else if(delta < 0 && (total + 1) % select_sample_rate == 0)
+            {
+                select_hints_.pop_back();
+            }
+
+            auto const superblock_count = super_ranks_.size() - 1;
+            for(auto loop = super_idx + 1; loop < superblock_count; ++loop)
+            {
+                auto const boundary_rank = delta > 0 ? super_ranks_[loop] - 1 : super_ranks_[loop];
+                if(boundary_rank % select_sample_rate == 0 && boundary_rank / select_sample_rate < select_hints_.size())
+                {
+                    repair_select_hint(static_cast<size_type>(boundary_rank / select_sample_rate));
+                }
+            }
+        }
+
+        // the last superblock starting at or before the sample
+        void repair_select_hint(size_type sample_idx)
+        {
+            auto const target = static_cast<uint64_t>(sample_idx * select_sample_rate);
+            auto const ranks_end = super_ranks_.begin() + static_cast<std::ptrdiff_t>(super_ranks_.size() - 1);
+            auto const super_itr = std::upper_bound(super_ranks_.begin(), ranks_end, target);
+            select_hints_[sample_idx] = static_cast<uint32_t>(std::distance(super_ranks_.begin(), super_itr) - 1);
+        }
+
+        void rebuild_index()
+        {
+            auto const block_count = static_cast<size_type>(bits_.block_size());
+            auto const superblock_count = (block_count + blocks_per_superblock - 1) / blocks_per_superblock;
+            block_ranks_.assign(block_count, 0);
+            super_ranks_.assign(superblock_count + 1, 0);
+
+            auto const* blocks = bits_.data();
+            for(size_type block_idx = 0; block_idx < block_count; ++block_idx)
+            {
+                if(block_idx % blocks_per_superblock != 0)
+                {
+                    block_ranks_[block_idx] = static_cast<uint16_t>(block_ranks_[block_idx - 1] + std::popcount(blocks[block_idx - 1]));
+                }
+            }
+            for(size_type super_idx = 1; super_idx <= superblock_count; ++super_idx)
+            {
+                super_ranks_[super_idx] = super_ranks_[super_idx - 1] + superblock_popcount(super_idx - 1);
+            }
+            rebuild_select_hints();
+        }
+
+        void rebuild_select_hints()
+        {
+            auto const total = super_ranks_.back();
+            select_hints_.assign(static_cast<size_t>(total / select_sample_rate + 1), 0);
+            size_type super_idx = 0;
+            for(size_type sample_idx = 0; sample_idx < select_hints_.size(); ++sample_idx)
+            {
+                auto const target = static_cast<uint64_t>(sample_idx * select_sample_rate);
+                while(super_idx + 1 < super_ranks_.size() - 1 && super_ranks_[super_idx + 1] <= target)
+                {
+                    ++super_idx;
+                }
+                select_hints_[sample_idx] = static_cast<uint32_t>(super_idx);
+            }
+        }
+    };
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "Base/Types.h"
+#include <assert.h>
+#include <cstring>
+#include <utility>
+
+namespace punk
+{
+    // vector keeping up to N elements inline, only trivially copyable elements so relocation is a memcpy
+    template <typename T, size_t N, typename Allocator = std::allocator<T>>
+    class small_vector
+    {
+        static_assert(N > 0);
+        static_assert(std::is_trivially_copyable_v<T>);
+
+    public: // export types
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = value_type const&;
+        using pointer = value_type*;
+        using const_pointer = value_type const*;
+        using iterator = pointer;
+        using const_iterator = const_pointer;
+
+        static constexpr size_type inline_capacity = N;
+
+    private:
+        using allocator_traits = std::allocator_traits<allocator_type>;
+
+        pointer                                 heap_;
+        size_type                               size_;
+        size_type                               capacity_;
+        [[no_unique_address]] allocator_type    alloc_;
+        alignas(T) value_type                   inline_[N];
+
+    public:
+        small_vector() noexcept
+            : small_vector(allocator_type{})
+        {
+        }
+
+        explicit small_vector(allocator_type const& alloc) noexcept
+            : heap_(nullptr)
+            , size_(0)
+            , capacity_(N)
+            , alloc_(alloc)
+        {
+        }
+
+        small_vector(size_type count, value_type const& value, allocator_type const& alloc = allocator_type{})
+            : small_vector(alloc)
+        {
+            resize(count, value);
+        }
+
+        small_vector(small_vector const& other)
+            : small_vector(allocator_traits::select_on_container_copy_construction(other.alloc_))
+        {
+            assign_from(other.data(), other.size());
+        }
+
+        small_vector(small_vector&& other) noexcept
+            : small_vector(other.alloc_)
+        {
+            steal_from(other);
+        }
+
+        small_vector& operator=(small_vector const& other)
+        {
+            if(&other != this)
+            {
+                assign_from(other.data(), other.size());
+            }
+            return *this;
+        }
+
+        small_vector& operator=(small_vector&& other) noexcept
+        {
+            if(&other != this)
+            {
+                release_heap();
+                steal_from(other);
+            }
+            return *this;
+        }
+
+        ~small_vector() noexcept
+        {
+            release_heap();
+        }
+
+    public: // element access
+        pointer data() noexcept { return heap_ ? heap_ : inline_; }
+        const_pointer data() const noexcept { return heap_ ? heap_ : inline_; }
+        reference operator[](size_type pos) noexcept { assert(pos < size_); return data()[pos]; }
+        const_reference operator[](size_type pos) const noexcept { assert(pos < size_); return data()[pos]; }
+        reference front() noexcept { assert(!empty()); return data()[0]; }
+        const_reference front() const noexcept { assert(!empty()); return data()[0]; }
+        reference back() noexcept { assert(!empty()); return data()[size_ - 1]; }
+        const_reference back() const noexcept { assert(!empty()); return data()[size_ - 1]; }
+
+    public: // iterators
+        iterator begin() noexcept { return data(); }
+        const_iterator begin() const noexcept { return data(); }
+        const_iterator cbegin() const noexcept { return data(); }
+        iterator end() noexcept { return data() + size_; }
+        const_iterator end() const noexcept { return data() + size_; }
+        const_iterator cend() const noexcept { return data() + size_; }
+
+    public: // capacity
+        size_type size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+        size_type capacity() const noexcept { return capacity_; }
+        bool is_inline() const noexcept { return heap_ == nullptr; }
+        allocator_type get_allocator() const noexcept { return alloc_; }
+
+        void reserve(size_type new_capacity)
+        {
+            if(new_capacity <= capacity_)
+            {
+                return;
+            }
+
+            auto* new_heap = allocator_traits::allocate(alloc_, new_capacity);
+            std::memcpy(new_heap, data(), size_ * sizeof(value_type));
+            release_heap();
+            heap_ = new_heap;
+            capacity_ = new_capacity;
+        }
+
+    public: // modifiers
+        void clear() noexcept
+        {
+            size_ = 0;
+        }
+
+        void resize(size_type count, value_type const& value = value_type{})
+        {
+            if(count > capacity_)
+            {
+                reserve((std::max)(count, capacity_ * 2));
+            }
+            if(count > size_)
+            {
+                std::fill(data() + size_, data() + count, value);
+            }
+            size_ = count;
+        }
+
+        void push_back(value_type const& value)
+        {
+            if(size_ == capacity_)
+            {
+                reserve(capacity_ * 2);
+            }
+            data()[size_++] = value;
+        }
+
+        void pop_back() noexcept
+        {
+            assert(!empty());
+            --size_;
+        }
+
+        void swap(small_vector& other) noexcept
+        {
+            small_vector temp{ std::move(other) };
+            other = std::move(*this);
+            *this = std::move(temp);
+        }
+
+        friend bool operator==(small_vector const& lhs, small_vector const& rhs) noexcept
+        {
+            return lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+    private:
+        void assign_from(const_pointer src, size_type count)
+        {
+            // stays inline whenever it fits, so copying small vectors never allocates
+            if(count > capacity_)
+            {
+                release_heap();
+                heap_ = allocator_traits::allocate(alloc_, count);
+                capacity_ = count;
+            }
+            std::memcpy(data(), src, count * sizeof(value_type));
+            size_ = count;
+        }
+
+        void steal_from(small_vector& other) noexcept
+        {
+            if(other.heap_)
+            {
+                heap_ = std::exchange(other.heap_, nullptr);
+                capacity_ = std::exchange(other.capacity_, N);
+            }
+            else
+            {
+                heap_ = nullptr;
+                capacity_ = N;
+                std::memcpy(inline_, other.inline_, other.size_ * sizeof(value_type));
+            }
+            size_ = std::exchange(other.size_, 0);
+        }
+
+        void release_heap() noexcept
+        {
+            if(heap_)
+            {
+                allocator_traits::deallocate(alloc_, heap_, capacity_);
+                heap_ = nullptr;
+                capacity_ = N;
+            }
+        }
+    };
+}
@@ -15,4 +15,20 @@ namespace punk
     using vector3 = DirectX::XMVECTOR;
     using vector4 = DirectX::XMVECTOR;
     using matrix4x4 = DirectX::XMMATRIX;
+
+    // interleaves the low 21 bits of x, y & z, nearby cells get nearby codes
+    constexpr uint64_t morton_encode3(uint32_t x, uint32_t y, uint32_t z) noexcept
+    {
+        auto const spread = [](uint64_t value)
+            {
+                value &= 0x1fffff;
+                value = (value | (value << 32)) & 0x1f00000000ffff;
+                value = (value | (value << 16)) & 0x1f0000ff0000ff;
+                value = (value | (value << 8)) & 0x100f00f00f00f00f;
+                value = (value | (value << 4)) & 0x10c30c30c30c30c3;
+                value = (value | (value << 2)) & 0x1249249249249249;
+                return value;
+            };
+        return spread(x) | (spread(y) << 1) | (spread(z) << 2);
+    }
 }
\ No newline at end of file
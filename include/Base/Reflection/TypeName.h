@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+
+namespace punk::detail
+{
+    template <typename T>
+    constexpr std::string_view get_type_signature() noexcept
+    {
+#if defined(_MSC_VER)
+        return __FUNCSIG__;
+#elif defined(__clang__) || defined(__GNUC__)
+        return __PRETTY_FUNCTION__;
+#else
+#error "Compiler Not Supported"
+#endif
+    }
+
+    // locate the type name inside the signature with a probe type
+    inline constexpr std::string_view type_signature_probe = get_type_signature<double>();
+    inline constexpr size_t type_signature_prefix = type_signature_probe.find("double");
+    inline constexpr size_t type_signature_suffix = type_signature_probe.length() - type_signature_prefix - std::string_view{ "double" }.length();
+    static_assert(type_signature_prefix != std::string_view::npos);
+
+#ifdef _MSC_VER
+    // same decorators get_demangle_name strips from typeid names
+    inline constexpr std::array<std::string_view, 4> type_signature_decorators
+    {{
+        "struct ",
+        "class ",
+        "enum ",
+        " "
+    }};
+#else
+    inline constexpr std::array<std::string_view, 0> type_signature_decorators{};
+#endif
+
+    template <typename Func>
+    constexpr void for_each_undecorated_char(std::string_view name, Func&& func)
+    {
+        for(size_t pos = 0; pos < name.length();)
+        {
+            size_t skip = 0;
+            for(auto const& decorator : type_signature_decorators)
+            {
+                if(name.substr(pos, decorator.length()) == decorator)
+                {
+                    skip = decorator.length();
+                    break;
+                }
+            }
+
+            if(skip > 0)
+            {
+                pos += skip;
+            }
+            else
+            {
+                func(name[pos++]);
+            }
+        }
+    }
+
+    template <typename T>
+    struct static_type_name_storage
+    {
+        static constexpr std::string_view signature_name = []()
+        {
+            constexpr auto signature = get_type_signature<T>();
+            return signature.substr(type_signature_prefix, signature.length() - type_signature_prefix - type_signature_suffix);
+        }();
+
+        static constexpr size_t length = []()
+        {
+            size_t result = 0;
+            for_each_undecorated_char(signature_name, [&](char) { ++result; });
+            return result;
+        }();
+
+        // null terminated, so it can be handed out as a c string
+        static constexpr std::array<char, length + 1> value = []()
+        {
+            std::array<char, length + 1> result{};
+            size_t index = 0;
+            for_each_undecorated_char(signature_name, [&](char c) { result[index++] = c; });
+            return result;
+        }();
+    };
+}
+
+namespace punk
+{
+    // type name derived from the compiler's function signature, no demangling & no allocation
+    template <typename T>
+    constexpr std::string_view get_static_type_name() noexcept
+    {
+        using storage = detail::static_type_name_storage<T>;
+        return { storage::value.data(), storage::length };
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Base/Types.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PUNK_CPU_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define PUNK_CPU_X86 0
+#endif
+
+namespace punk
+{
+    // instruction set extensions the runtime dispatched kernels care about
+    struct cpu_features
+    {
+        bool sse42 = false;
+        bool popcnt = false;
+        bool avx2 = false;
+    };
+
+    inline cpu_features detect_cpu_features() noexcept
+    {
+        cpu_features features{};
+#if PUNK_CPU_X86
+#if defined(_MSC_VER)
+        int info[4] = {};
+        __cpuid(info, 0);
+        auto const max_leaf = info[0];
+        __cpuid(info, 1);
+        features.sse42 = (info[2] & (1 << 20)) != 0;
+        features.popcnt = (info[2] & (1 << 23)) != 0;
+        bool const has_osxsave = (info[2] & (1 << 27)) != 0;
+        if(max_leaf >= 7 && has_osxsave && (_xgetbv(0) & 0x6) == 0x6)
+        {
+            __cpuidex(info, 7, 0);
+            features.avx2 = (info[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        features.sse42 = __builtin_cpu_supports("sse4.2");
+        features.popcnt = __builtin_cpu_supports("popcnt");
+        features.avx2 = __builtin_cpu_supports("avx2");
+#endif
+#endif
+        return features;
+    }
+
+    // detected once per process
+    inline cpu_features const& get_cpu_features() noexcept
+    {
+        static cpu_features const features = detect_cpu_features();
+        return features;
+    }
+}
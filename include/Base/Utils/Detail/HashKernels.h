@@ -0,0 +1,368 @@
+#pragma once
+
+#include "Base/Types.h"
+#include "Base/Utils/CpuFeatures.h"
+#include <cstring>
+#include <assert.h>
+
+#if PUNK_CPU_X86 && (defined(__clang__) || defined(__GNUC__))
+#define PUNK_TARGET_HASH_AVX2 __attribute__((target("avx2")))
+#else
+#define PUNK_TARGET_HASH_AVX2
+#endif
+
+// building blocks of hash_memory64: a wyhash core for short inputs and a striped bulk path for long ones
+// the bulk kernels are picked once at runtime, every level produces the same bits as the scalar reference
+namespace punk::detail
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 hash_uint128_t;
+#endif
+
+    inline constexpr uint64_t wyhash_secret[4] = { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+    // inputs longer than this take the bulk path
+    inline constexpr size_t hash_bulk_threshold = 256;
+    inline constexpr size_t hash_stripe_lanes = 8;
+    inline constexpr size_t hash_stripe_size = hash_stripe_lanes * sizeof(uint64_t);
+    inline constexpr size_t hash_stripes_per_block = 16;
+    inline constexpr size_t hash_block_size = hash_stripe_size * hash_stripes_per_block;
+
+    // stripe s, lane i is keyed with hash_stripe_keys[s + i], so equal stripes at different offsets differ
+    inline constexpr size_t hash_scramble_key_offset = 16;
+    inline constexpr size_t hash_tail_key_offset = 11;
+    inline constexpr size_t hash_merge_key_offset = 24;
+    inline constexpr auto hash_stripe_keys = []()
+    {
+        std::array<uint64_t, 32> keys{};
+        uint64_t state = wyhash_secret[0];
+        for(auto& key : keys)
+        {
+            // splitmix64
+            state += 0x9e3779b97f4a7c15ull;
+            uint64_t value = state;
+            value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+            value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+            key = value ^ (value >> 31);
+        }
+        return keys;
+    }();
+
+    // full 64 x 64 -> 128 multiply, low half in lhs & high half in rhs
+    constexpr void hash_mum(uint64_t& lhs, uint64_t& rhs) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        hash_uint128_t const product = static_cast<hash_uint128_t>(lhs) * rhs;
+        lhs = static_cast<uint64_t>(product);
+        rhs = static_cast<uint64_t>(product >> 64);
+#else
+#if defined(_MSC_VER) && defined(_M_X64)
+        if(!std::is_constant_evaluated())
+        {
+            uint64_t high = 0;
+            lhs = _umul128(lhs, rhs, &high);
+            rhs = high;
+            return;
+        }
+#endif
+        uint64_t const lo_lo = (lhs & 0xffffffffull) * (rhs & 0xffffffffull);
+        uint64_t const hi_lo = (lhs >> 32) * (rhs & 0xffffffffull);
+        uint64_t const lo_hi = (lhs & 0xffffffffull) * (rhs >> 32);
+        uint64_t const hi_hi = (lhs >> 32) * (rhs >> 32);
+        uint64_t const cross = (lo_lo >> 32) + (hi_lo & 0xffffffffull) + lo_hi;
+        lhs = (cross << 32) | (lo_lo & 0xffffffffull);
+        rhs = hi_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+    }
+
+    constexpr uint64_t hash_mix(uint64_t lhs, uint64_t rhs) noexcept
+    {
+        hash_mum(lhs, rhs);
+        return lhs ^ rhs;
+    }
+
+    // little endian loads, byte by byte during constant evaluation
+    template <size_t Bytes>
+    constexpr uint64_t hash_read(char const* ptr) noexcept
+    {
+        static_assert(Bytes == 4 || Bytes == 8);
+        if(std::is_constant_evaluated() || std::endian::native != std::endian::little)
+        {
+            uint64_t result = 0;
+            for(size_t loop = 0; loop < Bytes; ++loop)
+            {
+                result |= static_cast<uint64_t>(static_cast<uint8_t>(ptr[loop])) << (8 * loop);
+            }
+            return result;
+        }
+        else if constexpr(Bytes == 8)
+        {
+            uint64_t result;
+            std::memcpy(&result, ptr, sizeof(result));
+            return result;
+        }
+        else
+        {
+            uint32_t result;
+            std::memcpy(&result, ptr, sizeof(result));
+            return result;
+        }
+    }
+
+    constexpr uint64_t hash_read_small(char const* ptr, size_t len) noexcept
+    {
+        // 1 to 3 bytes
+        return (static_cast<uint64_t>(static_cast<uint8_t>(ptr[0])) << 16)
+            | (static_cast<uint64_t>(static_cast<uint8_t>(ptr[len >> 1])) << 8)
+            | static_cast<uint64_t>(static_cast<uint8_t>(ptr[len - 1]));
+    }
+
+    constexpr uint64_t wyhash(char const* ptr, size_t len, uint64_t seed) noexcept
+    {
+        seed ^= hash_mix(seed ^ wyhash_secret[0], wyhash_secret[1]);
+        uint64_t lhs = 0;
+        uint64_t rhs = 0;
+        if(len <= 16)
+        {
+            if(len >= 4)
+            {
+                auto const offset = (len >> 3) << 2;
+                lhs = (hash_read<4>(ptr) << 32) | hash_read<4>(ptr + offset);
+                rhs = (hash_read<4>(ptr + len - 4) << 32) | hash_read<4>(ptr + len - 4 - offset);
+            }
+            else if(len > 0)
+            {
+                lhs = hash_read_small(ptr, len);
+            }
+        }
+        else
+        {
+            auto remaining = len;
+            if(remaining >= 48)
+            {
+                uint64_t seed1 = seed;
+                uint64_t seed2 = seed;
+                do
+                {
+                    seed = hash_mix(hash_read<8>(ptr) ^ wyhash_secret[1], hash_read<8>(ptr + 8) ^ seed);
+                    seed1 = hash_mix(hash_read<8>(ptr + 16) ^ wyhash_secret[2], hash_read<8>(ptr + 24) ^ seed1);
+                    seed2 = hash_mix(hash_read<8>(ptr + 32) ^ wyhash_secret[3], hash_read<8>(ptr + 40) ^ seed2);
+                    ptr += 48;
+                    remaining -= 48;
+                } while(remaining >= 48);
+                seed ^= seed1 ^ seed2;
+            }
+            while(remaining > 16)
+            {
+                seed = hash_mix(hash_read<8>(ptr) ^ wyhash_secret[1], hash_read<8>(ptr + 8) ^ seed);
+                ptr += 16;
+                remaining -= 16;
+            }
+            lhs = hash_read<8>(ptr + remaining - 16);
+            rhs = hash_read<8>(ptr + remaining - 8);
+        }
+
+        lhs ^= wyhash_secret[1];
+        rhs ^= seed;
+        hash_mum(lhs, rhs);
+        return hash_mix(lhs ^ wyhash_secret[0] ^ len, rhs ^ wyhash_secret[1]);
+    }
+
+    enum class hash_kernel_level : uint8_t
+    {
+        scalar = 0,
+        sse2 = 1,
+        avx2 = 2,
+    };
+
+    struct hash_kernels
+    {
+        hash_kernel_level level;
+        // acc[i ^ 1] += lane i, acc[i] += lo32(lane ^ key) * hi32(lane ^ key) for every stripe
+        void(*accumulate)(uint64_t* acc, char const* data, size_t stripe_count, uint64_t const* keys);
+        // acc ^= acc >> 47, acc ^= key, acc *= 32-bit prime
+        void(*scramble)(uint64_t* acc, uint64_t const* keys);
+    };
+
+    inline constexpr uint32_t hash_scramble_prime = 0x9e3779b1u;
+
+    // scalar reference, also used during constant evaluation
+    namespace scalar_hash_kernels
+    {
+        constexpr void accumulate(uint64_t* acc, char const* data, size_t stripe_count, uint64_t const* keys) noexcept
+        {
+            for(size_t stripe = 0; stripe < stripe_count; ++stripe)
+            {
+                for(size_t lane = 0; lane < hash_stripe_lanes; ++lane)
+                {
+                    auto const value = hash_read<8>(data + stripe * hash_stripe_size + lane * sizeof(uint64_t));
+                    auto const keyed = value ^ keys[stripe + lane];
+                    acc[lane ^ 1] += value;
+                    acc[lane] += (keyed & 0xffffffffull) * (keyed >> 32);
+                }
+            }
+        }
+
+        constexpr void scramble(uint64_t* acc, uint64_t const* keys) noexcept
+        {
+            for(size_t lane = 0; lane < hash_stripe_lanes; ++lane)
+            {
+                acc[lane] ^= acc[lane] >> 47;
+                acc[lane] ^= keys[lane];
+                acc[lane] *= hash_scramble_prime;
+            }
+        }
+    }
+
+#if PUNK_CPU_X86
+    // sse2 is part of the x86-64 baseline
+    namespace sse2_hash_kernels
+    {
+        inline void accumulate(uint64_t* acc, char const* data, size_t stripe_count, uint64_t const* keys) noexcept
+        {
+            __m128i lanes[4];
+            for(size_t loop = 0; loop < 4; ++loop)
+            {
+                lanes[loop] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(acc + loop * 2));
+            }
+            for(size_t stripe = 0; stripe < stripe_count; ++stripe)
+            {
+                auto const* stripe_data = data + stripe * hash_stripe_size;
+                for(size_t loop = 0; loop < 4; ++loop)
+                {
+                    auto const value = _mm_loadu_si128(reinterpret_cast<__m128i const*>(stripe_data) + loop);
+                    auto const keyed = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<__m128i const*>(keys + stripe + loop * 2)));
+                    auto const product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+                    auto const swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+                    lanes[loop] = _mm_add_epi64(lanes[loop], _mm_add_epi64(product, swapped));
+                }
+            }
+            for(size_t loop = 0; loop < 4; ++loop)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + loop * 2), lanes[loop]);
+            }
+        }
+
+        inline void scramble(uint64_t* acc, uint64_t const* keys) noexcept
+        {
+            auto const prime = _mm_set1_epi32(static_cast<int>(hash_scramble_prime));
+            for(size_t loop = 0; loop < 4; ++loop)
+            {
+                auto lanes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(acc + loop * 2));
+                lanes = _mm_xor_si128(lanes, _mm_srli_epi64(lanes, 47));
+                lanes = _mm_xor_si128(lanes, _mm_loadu_si128(reinterpret_cast<__m128i const*>(keys + loop * 2)));
+                auto const low = _mm_mul_epu32(lanes, prime);
+                auto const high = _mm_mul_epu32(_mm_srli_epi64(lanes, 32), prime);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + loop * 2), _mm_add_epi64(low, _mm_slli_epi64(high, 32)));
+            }
+        }
+    }
+
+    namespace avx2_hash_kernels
+    {
+        PUNK_TARGET_HASH_AVX2 inline void accumulate(uint64_t* acc, char const* data, size_t stripe_count, uint64_t const* keys) noexcept
+        {
+            __m256i lanes[2];
+            for(size_t loop = 0; loop < 2; ++loop)
+            {
+                lanes[loop] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(acc + loop * 4));
+            }
+            for(size_t stripe = 0; stripe < stripe_count; ++stripe)
+            {
+                auto const* stripe_data = data + stripe * hash_stripe_size;
+                for(size_t loop = 0; loop < 2; ++loop)
+                {
+                    auto const value = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(stripe_data) + loop);
+                    auto const keyed = _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(keys + stripe + loop * 4)));
+                    auto const product = _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+                    auto const swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+                    lanes[loop] = _mm256_add_epi64(lanes[loop], _mm256_add_epi64(product, swapped));
+                }
+            }
+            for(size_t loop = 0; loop < 2; ++loop)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + loop * 4), lanes[loop]);
+            }
+        }
+
+        PUNK_TARGET_HASH_AVX2 inline void scramble(uint64_t* acc, uint64_t const* keys) noexcept
+        {
+            auto const prime = _mm256_set1_epi32(static_cast<int>(hash_scramble_prime));
+            for(size_t loop = 0; loop < 2; ++loop)
+            {
+                auto lanes = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(acc + loop * 4));
+                lanes = _mm256_xor_si256(lanes, _mm256_srli_epi64(lanes, 47));
+                lanes = _mm256_xor_si256(lanes, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(keys + loop * 4)));
+                auto const low = _mm256_mul_epu32(lanes, prime);
+                auto const high = _mm256_mul_epu32(_mm256_srli_epi64(lanes, 32), prime);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + loop * 4), _mm256_add_epi64(low, _mm256_slli_epi64(high, 32)));
+            }
+        }
+    }
+#endif
+
+    inline hash_kernel_level detect_hash_kernel_level() noexcept
+    {
+#if PUNK_CPU_X86
+        return get_cpu_features().avx2 ? hash_kernel_level::avx2 : hash_kernel_level::sse2;
+#else
+        return hash_kernel_level::scalar;
+#endif
+    }
+
+    inline hash_kernels make_hash_kernels(hash_kernel_level level) noexcept
+    {
+        switch(level)
+        {
+#if PUNK_CPU_X86
+        case hash_kernel_level::avx2:
+            return { level, avx2_hash_kernels::accumulate, avx2_hash_kernels::scramble };
+        case hash_kernel_level::sse2:
+            return { level, sse2_hash_kernels::accumulate, sse2_hash_kernels::scramble };
+#endif
+        default:
+            return { hash_kernel_level::scalar, scalar_hash_kernels::accumulate, scalar_hash_kernels::scramble };
+        }
+    }
+
+    // selected once per process
+    inline hash_kernels const& get_hash_kernels() noexcept
+    {
+        static hash_kernels const kernels = make_hash_kernels(detect_hash_kernel_level());
+        return kernels;
+    }
+
+    // striped bulk hash for inputs of at least one stripe, 1 KB blocks are scrambled between each other
+    template <typename Accumulate, typename Scramble>
+    constexpr uint64_t hash_bulk(char const* data, size_t len, uint64_t seed, Accumulate&& accumulate, Scramble&& scramble) noexcept
+    {
+        assert(len >= hash_stripe_size);
+        auto const* keys = hash_stripe_keys.data();
+
+        uint64_t acc[hash_stripe_lanes]{};
+        for(size_t lane = 0; lane < hash_stripe_lanes; ++lane)
+        {
+            acc[lane] = keys[hash_merge_key_offset + lane] + seed;
+        }
+
+        // the last stripe is always consumed by the overlapping tail below
+        auto const block_count = (len - 1) / hash_block_size;
+        for(size_t block = 0; block < block_count; ++block)
+        {
+            accumulate(acc, data + block * hash_block_size, hash_stripes_per_block, keys);
+            scramble(acc, keys + hash_scramble_key_offset);
+        }
+        auto const block_end = block_count * hash_block_size;
+        accumulate(acc, data + block_end, (len - 1 - block_end) / hash_stripe_size, keys);
+        accumulate(acc, data + len - hash_stripe_size, 1, keys + hash_tail_key_offset);
+
+        uint64_t result = (len * 0x9e3779b185ebca87ull) ^ seed;
+        for(size_t lane = 0; lane < hash_stripe_lanes; lane += 2)
+        {
+            result += hash_mix(acc[lane] ^ keys[lane], acc[lane + 1] ^ keys[lane + 1]);
+        }
+        result ^= result >> 37;
+        result *= 0x165667919e3779f9ull;
+        return result ^ (result >> 32);
+    }
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Base/Utils/Detail/HashKernels.h"
+
 namespace punk
 {
     constexpr uint32_t murmur_rotl(uint32_t x, int8_t r) noexcept
@@ -29,6 +31,23 @@ namespace punk
         return result;
     }
 
+    constexpr uint64_t murmur_fmix64(uint64_t const h) noexcept
+    {
+        uint64_t result = h;
+        result ^= result >> 33;
+        result *= 0xff51afd7ed558ccdull;
+        result ^= result >> 33;
+        result *= 0xc4ceb9fe1a85ec53ull;
+        result ^= result >> 33;
+        return result;
+    }
+
+    // fold value into a 64-bit running hash, order dependent
+    constexpr uint64_t hash_combine64(uint64_t const seed, uint64_t const value) noexcept
+    {
+        return murmur_fmix64(seed ^ (murmur_fmix64(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2)));
+    }
+
     constexpr uint32_t murmurhash3_x86_32_impl(char const* key, int const len, uint32_t const seed)
     {
         int const nblocks = len / 4;
@@ -96,6 +115,13 @@ namespace punk
         return murmur_hash_x86_32(arr, ecs_seed);
     }
 
+    constexpr uint32_t hash_memory(std::string_view str)
+    {
+        // hex from of 'x' 'e' 'c' 's'
+        constexpr uint32_t ecs_seed = 0x78656373;
+        return murmurhash3_x86_32_impl(str.data(), static_cast<int>(str.length()), ecs_seed);
+    }
+
     inline uint32_t hash_memory(char const* arr, size_t const len)
     {
         // hex from of 'x' 'e' 'c' 's'
@@ -103,6 +129,27 @@ namespace punk
         return murmur_hash_x86_32(arr, static_cast<int>(len), ecs_seed);
     }
 
+    // 64-bit wyhash-class hash, short inputs go through the wyhash core & long ones through the striped bulk path
+    // usable at compile time, the runtime simd kernels produce the same value
+    constexpr uint64_t hash_memory64(char const* data, size_t const len, uint64_t const seed = 0x78656373) noexcept
+    {
+        if(len <= detail::hash_bulk_threshold)
+        {
+            return detail::wyhash(data, len, seed);
+        }
+        if(std::is_constant_evaluated())
+        {
+            return detail::hash_bulk(data, len, seed, detail::scalar_hash_kernels::accumulate, detail::scalar_hash_kernels::scramble);
+        }
+        auto const& kernels = detail::get_hash_kernels();
+        return detail::hash_bulk(data, len, seed, kernels.accumulate, kernels.scramble);
+    }
+
+    constexpr uint64_t hash_memory64(std::string_view str, uint64_t const seed = 0x78656373) noexcept
+    {
+        return hash_memory64(str.data(), str.length(), seed);
+    }
+
     // TODO ... move to a better header
     template <typename T> requires(std::is_integral_v<T>)
     constexpr T align_up_with_mask(T value, T mask)
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string_view>
+#include "Base/Types.h"
+#include "ECS/Detail/ErrorCode.h"
+#include "ECS/Detail/Meta.h"
+
+namespace punk
+{
+    class archetype_registry_t;
+    class runtime_type_registry_t;
+
+    // archetypes & transitions a level is known to use, precreated before the first frame
+    // text format, one statement per line, type names as reported by get_type_name:
+    //   # comment
+    //   archetype <type name>; <type name>; ...
+    //   + <type name>      the archetype above gains a component
+    //   - <type name>      the archetype above loses a component
+    struct archetype_manifest_t
+    {
+        struct transition_t
+        {
+            bool                    include;
+            string                  component_type_name;
+        };
+
+        struct archetype_entry_t
+        {
+            vector<string>          component_type_names;
+            vector<transition_t>    transitions;
+        };
+
+        vector<archetype_entry_t>   archetypes;
+    };
+
+    // parse text into manifest, error_line receives the 1-based line of a syntax error
+    error_code parse_archetype_manifest(std::string_view text, archetype_manifest_t& manifest, size_t* error_line = nullptr);
+
+    // format manifest as text parse_archetype_manifest accepts
+    string write_archetype_manifest(archetype_manifest_t const& manifest);
+
+    // the archetypes currently registered, e.g. captured at the end of a play session to produce a manifest
+    archetype_manifest_t capture_archetype_manifest(archetype_registry_t* archetype_registry);
+
+    // create every archetype & transition target of manifest, preloaded keeps them alive until the level ends
+    // entries naming an unregistered type are skipped & reported by unknown_component_type, the rest still load
+    error_code preload_archetypes(archetype_registry_t* archetype_registry, runtime_type_registry_t* runtime_type_registry,
+        archetype_manifest_t const& manifest, vector<archetype_ptr>& preloaded);
+}
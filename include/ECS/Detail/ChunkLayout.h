@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Base/Types.h"
+#include "Base/Utils/Hash.h"
+
+namespace punk
+{
+    // every chunk is one fixed size block, a header followed by one column per component
+    inline constexpr uint32_t chunk_size_in_bytes = 16 * 1024;
+    inline constexpr uint32_t chunk_header_size_in_bytes = 16;
+    // every row records its entity, queries join other storages through it
+    inline constexpr uint32_t chunk_entity_size_in_bytes = 8;
+    // every column with storage carries the version of its last write, queries skip chunks unchanged since a version
+    inline constexpr uint32_t chunk_change_version_size_in_bytes = 4;
+
+    // words of one enable mask, a bit per row
+    constexpr uint32_t chunk_enable_mask_words(uint32_t capacity) noexcept
+    {
+        return (capacity + 63) / 64;
+    }
+
+    // lay out the columns of count components in the given order, fills offsets & returns the rows per chunk
+    // shared by the runtime archetype registry & static_archetype, so both always agree
+    // the change versions of the columns with storage follow the header, one per column in the given order
+    // shared[index] marks a column holding one value per chunk, those come next before any row column
+    // enable_mask_count masks of chunk_enable_mask_words(capacity) words come next, starting at enable_masks_offset
+    // the entity column follows at entities_offset, then the component columns
+    // zero size columns (tags) take no space, they all start at the data block so their address stays inside the chunk
+    constexpr uint32_t compute_chunk_layout(uint32_t const* sizes, uint32_t const* alignments, size_t count, uint32_t* offsets,
+        bool const* shared = nullptr, uint32_t enable_mask_count = 0, uint32_t* enable_masks_offset = nullptr, uint32_t* entities_offset = nullptr) noexcept
+    {
+        uint32_t row_size = chunk_entity_size_in_bytes;
+        uint32_t shared_end = chunk_header_size_in_bytes;
+        for(size_t index = 0; index < count; ++index)
+        {
+            shared_end += sizes[index] != 0 ? chunk_change_version_size_in_bytes : 0;
+        }
+        for(size_t index = 0; index < count; ++index)
+        {
+            if(sizes[index] == 0)
+            {
+                offsets[index] = chunk_header_size_in_bytes;
+            }
+            else if(shared && shared[index])
+            {
+                offsets[index] = align_up(shared_end, (std::max)(alignments[index], 1u));
+                shared_end = offsets[index] + sizes[index];
+            }
+            else
+            {
+                row_size += sizes[index];
+            }
+        }
+
+        if(shared_end > chunk_size_in_bytes)
+        {
+            return 0;
+        }
+
+        auto const masks_offset = align_up(shared_end, static_cast<uint32_t>(alignof(uint64_t)));
+        if(enable_masks_offset)
+        {
+            *enable_masks_offset = masks_offset;
+        }
+
+        for(auto capacity = (chunk_size_in_bytes - shared_end) / row_size; capacity > 0; --capacity)
+        {
+            // alignment padding & masks may push the estimate over the block, shrink until it fits
+            auto const entities = masks_offset + enable_mask_count * chunk_enable_mask_words(capacity) * 8;
+            if(entities_offset)
+            {
+                *entities_offset = entities;
+            }
+
+            auto size = entities + chunk_entity_size_in_bytes * capacity;
+            for(size_t index = 0; index < count; ++index)
+            {
+                if(sizes[index] == 0 || (shared && shared[index]))
+                {
+                    continue;
+                }
+                offsets[index] = align_up(size, (std::max)(alignments[index], 1u));
+                size = offsets[index] + sizes[index] * capacity;
+            }
+
+            if(size <= chunk_size_in_bytes)
+            {
+                return capacity;
+            }
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Base/Types.h"
+#include "ECS/Detail/Meta.h"
+#include "ECS/Detail/Entity.h"
+#include <span>
+#include <assert.h>
+
+namespace punk
+{
+    enum class component_event_t : uint8_t
+    {
+        added,
+        removed,
+        // chunk granularity, every entity of a chunk written through a view
+        changed,
+    };
+
+    // per world queues of entities that gained, lost or changed a component since the last consume
+    // every subscription owns its queue, so consumers never steal batches from each other
+    // archetype instances only publish when has_subscribers(), so an unused world pays one branch per structural change
+    // publishing & consuming follow structural changes, they are not concurrent
+    class component_event_queues_t
+    {
+    private:
+        struct subscription_t
+        {
+            type_info_t const*  type;
+            component_event_t   event;
+            bool                active;
+            vector<entity_t>    entities;
+        };
+
+        vector<subscription_t>  subscriptions_;
+        uint32_t                active_count_ = 0;
+
+    public:
+        component_event_queues_t() = default;
+        component_event_queues_t(component_event_queues_t const&) = delete;
+        component_event_queues_t& operator=(component_event_queues_t const&) = delete;
+
+    public: // subscriptions
+        uint32_t subscribe(type_info_t const* type, component_event_t event)
+        {
+            assert(type);
+            ++active_count_;
+            for(uint32_t index = 0; index < subscriptions_.size(); ++index)
+            {
+                if(!subscriptions_[index].active)
+                {
+                    subscriptions_[index] = { type, event, true, {} };
+                    return index;
+                }
+            }
+            subscriptions_.push_back({ type, event, true, {} });
+            return static_cast<uint32_t>(subscriptions_.size() - 1);
+        }
+
+        void unsubscribe(uint32_t subscription)
+        {
+            assert(subscription < subscriptions_.size() && subscriptions_[subscription].active);
+            subscriptions_[subscription].active = false;
+            subscriptions_[subscription].entities = {};
+            --active_count_;
+        }
+
+        bool has_subscribers() const noexcept { return active_count_ != 0; }
+
+        bool is_subscribed(type_info_t const* type, component_event_t event) const noexcept
+        {
+            return std::ranges::any_of(subscriptions_,
+                [=](subscription_t const& subscription)
+                {
+                    return subscription.active && subscription.type == type && subscription.event == event;
+                });
+        }
+
+    public: // producers
+        void publish(type_info_t const* type, component_event_t event, entity_t const* entities, size_t count)
+        {
+            for(auto& subscription : subscriptions_)
+            {
+                if(subscription.active && subscription.type == type && subscription.event == event)
+                {
+                    subscription.entities.insert(subscription.entities.end(), entities, entities + count);
+                }
+            }
+        }
+
+    public: // consumers
+        // events in publish order, an entity may appear more than once
+        std::span<entity_t const> peek(uint32_t subscription) const noexcept
+        {
+            assert(subscription < subscriptions_.size());
+            return subscriptions_[subscription].entities;
+        }
+
+        // func(std::span<entity_t const>) with everything queued, the queue is empty afterwards
+        template <typename Func>
+        void consume(uint32_t subscription, Func&& func)
+        {
+            assert(subscription < subscriptions_.size() && subscriptions_[subscription].active);
+            auto& entities = subscriptions_[subscription].entities;
+            func(std::span<entity_t const>{ entities });
+            entities.clear();
+        }
+    };
+}
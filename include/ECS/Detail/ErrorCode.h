@@ -11,5 +11,7 @@ namespace punk
         invalid_archetype           = -4,
         archetype_count_overflow    = -5,
         index_overflow              = -6,
+        manifest_syntax_error       = -7,
+        unknown_component_type      = -8,
     };
 }
\ No newline at end of file
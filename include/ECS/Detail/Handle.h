@@ -139,5 +139,10 @@ namespace punk
             using integral_type_info = type_info_traits<T>;
             return std::format("punk::handle<{}, {}>", tag_type_info::get_type_name(), integral_type_info::get_type_name());
         }
+
+        static uint32_t get_type_name_hash()
+        {
+            return hash_memory(get_type_name());
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "Base/Types.h"
+#include "ECS/Detail/Entity.h"
+#include "ECS/Detail/SparseStorage.h"
+#include <span>
+#include <assert.h>
+
+namespace punk
+{
+    // parent-child relationships with the children of every parent packed in one array
+    //  a node knows its parent & its index in the parent's array, so reparenting is a swap & pop plus a push
+    //  depth first walks read sibling arrays front to back instead of chasing sibling links across chunks
+    // entities without a parent that are part of the hierarchy are the roots, the walks start there
+    class entity_hierarchy
+    {
+    private:
+        struct node_t
+        {
+            entity_t            parent;
+            // index in the children of parent, or in roots_ without a parent
+            uint32_t            index_in_parent = 0;
+            vector<entity_t>    children;
+        };
+
+        sparse_storage<node_t>  nodes_;
+        vector<entity_t>        roots_;
+
+    public:
+        entity_hierarchy() = default;
+        entity_hierarchy(entity_hierarchy const&) = delete;
+        entity_hierarchy& operator=(entity_hierarchy const&) = delete;
+
+    public: // lookup
+        bool contains(entity_t entity) const noexcept { return nodes_.contains(entity); }
+        size_t size() const noexcept { return nodes_.size(); }
+
+        // an invalid entity for roots & entities outside the hierarchy
+        entity_t get_parent(entity_t entity) const noexcept
+        {
+            auto const* node = nodes_.find(entity);
+            return node ? node->parent : entity_t{};
+        }
+
+        std::span<entity_t const> get_children(entity_t entity) const noexcept
+        {
+            auto const* node = nodes_.find(entity);
+            return node ? std::span<entity_t const>{ node->children } : std::span<entity_t const>{};
+        }
+
+        std::span<entity_t const> get_roots() const noexcept { return roots_; }
+
+        bool is_ancestor(entity_t ancestor, entity_t entity) const noexcept
+        {
+            for(auto parent = get_parent(entity); parent.is_valid(); parent = get_parent(parent))
+            {
+                if(parent.get_value() == ancestor.get_value())
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    public: // modifiers
+        // moves child under parent, an invalid parent makes child a root, both join the hierarchy when needed
+        void set_parent(entity_t child, entity_t parent)
+        {
+            assert(child.is_valid() && child.get_value() != parent.get_value());
+            assert((!parent.is_valid() || !is_ancestor(child, parent)) && "reparenting would create a cycle");
+
+            if(parent.is_valid() && !nodes_.contains(parent))
+            {
+                insert_root(parent);
+            }
+            if(nodes_.contains(child))
+            {
+                detach(child);
+            }
+            else
+            {
+                nodes_.emplace(child);
+            }
+
+            // dense values may have moved while inserting, look the nodes up again
+            auto& siblings = parent.is_valid() ? nodes_.find(parent)->children : roots_;
+            auto* node = nodes_.find(child);
+            node->parent = parent;
+            node->index_in_parent = static_cast<uint32_t>(siblings.size());
+            siblings.push_back(child);
+        }
+
+        // takes entity out of the hierarchy, its children become roots
+        bool erase(entity_t entity)
+        {
+            auto* node = nodes_.find(entity);
+            if(!node)
+            {
+                return false;
+            }
+
+            for(auto const child : std::exchange(node->children, {}))
+            {
+                auto* child_node = nodes_.find(child);
+                child_node->parent = entity_t{};
+                child_node->index_in_parent = static_cast<uint32_t>(roots_.size());
+                roots_.push_back(child);
+            }
+            detach(entity);
+            return nodes_.erase(entity);
+        }
+
+        void clear() noexcept
+        {
+            nodes_.clear();
+            roots_.clear();
+        }
+
+    public: // traversal
+        // func(entity_t entity, entity_t parent, uint32_t depth) for every entity, parents before their children
+        template <typename Func>
+        void for_each_depth_first(Func&& func) const
+        {
+            for(auto const root : roots_)
+            {
+                for_each_depth_first(root, func);
+            }
+        }
+
+        // the same walk over the subtree of root, root included
+        template <typename Func>
+        void for_each_depth_first(entity_t root, Func&& func) const
+        {
+            struct frame_t
+            {
+                entity_t    entity;
+                uint32_t    depth;
+            };
+
+            vector<frame_t> stack{ { root, 0 } };
+            while(!stack.empty())
+            {
+                auto const [entity, depth] = stack.back();
+                stack.pop_back();
+
+                auto const* node = nodes_.find(entity);
+                func(entity, node ? node->parent : entity_t{}, depth);
+                if(node)
+                {
+                    // pushed in reverse so siblings are visited in array order
+                    for(auto itr = node->children.rbegin(); itr != node->children.rend(); ++itr)
+                    {
+                        stack.push_back({ *itr, depth + 1 });
+                    }
+                }
+            }
+        }
+
+    private:
+        void insert_root(entity_t entity)
+        {
+            auto& node = nodes_.emplace(entity);
+            node.index_in_parent = static_cast<uint32_t>(roots_.size());
+            roots_.push_back(entity);
+        }
+
+        // removes entity from the array of its parent, the last sibling fills the hole
+        void detach(entity_t entity)
+        {
+            auto const* node = nodes_.find(entity);
+            auto& siblings = node->parent.is_valid() ? nodes_.find(node->parent)->children : roots_;
+            auto const index = node->index_in_parent;
+            assert(index < siblings.size() && siblings[index].get_value() == entity.get_value());
+
+            siblings[index] = siblings.back();
+            siblings.pop_back();
+            if(index < siblings.size())
+            {
+                nodes_.find(siblings[index])->index_in_parent = index;
+            }
+        }
+    };
+}
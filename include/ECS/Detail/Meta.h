@@ -26,6 +26,7 @@ namespace punk
         return lhs.value <=> rhs.value;
     }
 
+    // a null function means the operation is trivial
     struct type_vtable_t
     {
         void(*constructor)(void*);
@@ -33,6 +34,21 @@ namespace punk
         void(*copy_func)(void*, void const*);
         void(*swap_func)(void*, void*);
         void(*move_func)(void*, void*);
+
+        // range variants over count contiguous objects, one indirect call per column
+        void(*construct_n)(void*, size_t);
+        void(*destroy_n)(void*, size_t);
+        // copy assign over constructed objects
+        void(*copy_n)(void*, void const*, size_t);
+        // move construct into uninitialized dst & destroy src, the ranges must not overlap
+        void(*relocate_n)(void*, void*, size_t);
+
+        // copy_n is a memcpy
+        bool trivially_copyable;
+        // relocate_n is a memcpy
+        bool trivially_relocatable;
+        // no state, a tag component that owns no column & is never constructed
+        bool empty;
     };
 
     enum class component_tag_t : uint8_t
@@ -40,6 +56,8 @@ namespace punk
         none = 0x00,
         data = 0x01,
         copy_on_write = 0x02,
+        shared = 0x04,
+        enableable = 0x08,
     };
 
     // chunk is a list of chained memroy block, where the data is actually placed
@@ -60,6 +78,26 @@ namespace punk
     // TODO ... abi
     using archetype_ptr = std::shared_ptr<archetype_t>;
     using archetype_weak = std::weak_ptr<archetype_t>;
+
+    // non-owning archetype reference for hot paths, copying it never touches a reference count
+    // valid while an archetype_ptr owns the archetype, or while the owning registry is pinned
+    class archetype_handle_t
+    {
+    private:
+        archetype_t const*  archetype_ = nullptr;
+
+    public:
+        constexpr archetype_handle_t() noexcept = default;
+        constexpr explicit archetype_handle_t(archetype_t const* archetype) noexcept : archetype_(archetype) {}
+        archetype_handle_t(archetype_ptr const& archetype) noexcept : archetype_(archetype.get()) {}
+
+    public:
+        constexpr archetype_t const* get() const noexcept { return archetype_; }
+        constexpr archetype_t const* operator->() const noexcept { return archetype_; }
+        constexpr bool is_valid() const noexcept { return archetype_ != nullptr; }
+        constexpr explicit operator bool() const noexcept { return is_valid(); }
+        friend constexpr bool operator==(archetype_handle_t const&, archetype_handle_t const&) noexcept = default;
+    };
 }
 
 /// TODO ... not all the interfaces below are public, hide the implementation specific ones
@@ -96,6 +134,9 @@ namespace punk
     type_hash_t get_type_hash(type_info_t const* type_info);
     uint32_t get_type_name_hash(type_info_t const* type_info);
 
+    // column order of archetype signatures, by name hash & by full name when two names share the hash
+    bool type_info_less(type_info_t const* lhs, type_info_t const* rhs);
+
     // get field count
     uint32_t get_type_field_count(type_info_t const* type_info);
 
@@ -109,8 +150,25 @@ namespace punk
     // get component group
     uint32_t get_type_component_group(type_info_t const* type_info);
 
+    // tags take part in archetype signatures but occupy no chunk space
+    bool is_tag_component(type_info_t const* type_info);
+
+    // shared components are stored once per chunk
+    bool is_shared_component(type_info_t const* type_info);
+
+    // enableable components carry a per chunk enable mask next to their column
+    bool is_enableable_component(type_info_t const* type_info);
+
     // set hash for fields
     void update_hash_for_fields(type_info_t* type_info);
+
+    // column operations over count contiguous objects, a memset/memcpy or one indirect call
+    void construct_objects(type_info_t const* type_info, void* dst, size_t count);
+    void destroy_objects(type_info_t const* type_info, void* dst, size_t count);
+    void copy_objects(type_info_t const* type_info, void* dst, void const* src, size_t count);
+    void relocate_objects(type_info_t const* type_info, void* dst, void* src, size_t count);
+    // count copies of one object into uninitialized dst, doubling memcpys or construct & copy_func per object
+    void fill_objects(type_info_t const* type_info, void* dst, void const* src, size_t count);
 }
 
 // interfaces for field_info_t
@@ -129,6 +187,40 @@ namespace punk
     uint32_t get_field_offset(field_info_t* field_info);
 }
 
+// interfaces for archetype_t & chunk_t
+namespace punk
+{
+    // get the signature hash
+    uint64_t get_archetype_hash(archetype_t const* archetype);
+
+    // get component count
+    uint32_t get_archetype_component_count(archetype_t const* archetype);
+
+    // get rows per chunk
+    uint32_t get_archetype_capacity(archetype_t const* archetype);
+
+    // find the column of a component, invalid_index_value() when the archetype does not have it
+    uint32_t find_archetype_component(archetype_t const* archetype, type_info_t const* component_type);
+
+    // get the offset of a column from the chunk base
+    uint32_t get_archetype_component_offset(archetype_t const* archetype, uint32_t column);
+
+    // get the offset of the entity column from the chunk base
+    uint32_t get_archetype_entities_offset(archetype_t const* archetype);
+
+    // get the offset of the enable mask of a column, invalid_offset_value() for components that are not enableable
+    uint32_t get_archetype_enable_mask_offset(archetype_t const* archetype, uint32_t column);
+
+    // get the offset of the uint32_t change version of a column, invalid_offset_value() for tags
+    uint32_t get_archetype_change_version_offset(archetype_t const* archetype, uint32_t column);
+
+    // get the shared value of a column in chunk, the column must hold a shared component
+    void const* get_chunk_shared_value(archetype_t const* archetype, chunk_t const* chunk, uint32_t column);
+
+    // get the number of rows in use
+    uint32_t get_chunk_element_count(chunk_t const* chunk);
+}
+
 namespace std
 {
     template <>
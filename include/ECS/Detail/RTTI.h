@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include "Base/Utils/StaticFor.h"
 #include "Base/Async/AsyncStaticFor.h"
+#include "Base/Async/EpochDomain.h"
 
 namespace punk
 {
@@ -21,6 +23,30 @@ namespace punk
         };
         using type_info_ptr = std::unique_ptr<type_info_t, type_info_deleter>;
 
+    private:
+        // per type & per thread cache of the last resolved type info, tagged with the registry id
+        // ids are never reused, so a cache filled by a destroyed registry never hits
+        struct cached_type_info_t
+        {
+            uint64_t            registry_id = 0;
+            type_info_t const*  type_info = nullptr;
+        };
+
+        template <typename T>
+        static cached_type_info_t& get_cached_type_info() noexcept
+        {
+            thread_local cached_type_info_t cache{};
+            return cache;
+        }
+
+        static uint64_t allocate_registry_id() noexcept
+        {
+            static std::atomic<uint64_t> next_registry_id{ 1 };
+            return next_registry_id.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        uint64_t const registry_id_ = allocate_registry_id();
+
     public:
         runtime_type_registry_t() = default;
         runtime_type_registry_t(runtime_type_registry_t const&) = delete;
@@ -34,7 +60,9 @@ namespace punk
 
     public:
         // get type_info
+        // exact, types are keyed by their full name
         virtual type_info_t const* get_type_info(char const* type_name) const = 0;
+        // the first type registered under the hash, a later name sharing it is only found by name
         virtual type_info_t const* get_type_info(uint32_t type_name_hash) const = 0;
 
         // register a type info object created from meta interface
@@ -43,13 +71,28 @@ namespace punk
         // generic get_or_create_type_info
         template <typename T>
         type_info_t const* get_or_create_type_info()
+        {
+            // fast path, no hashing & no lookup
+            auto& cache = get_cached_type_info<T>();
+            if (cache.registry_id == registry_id_)
+            {
+                return cache.type_info;
+            }
+
+            auto const* type_info = get_or_create_type_info_uncached<T>();
+            cache = { registry_id_, type_info };
+            return type_info;
+        }
+
+    private:
+        template <typename T>
+        type_info_t const* get_or_create_type_info_uncached()
         {
             using type_info_traits_t = type_info_traits<T>;
             auto const type_name = type_info_traits_t::get_type_name();
-            auto const type_name_hash = hash_memory(type_name.c_str(), type_name.length());
 
-            // query exist type info
-            auto* type_info = get_type_info(type_name_hash);
+            // query exist type info by its full name, another type sharing the name hash never matches
+            auto* type_info = get_type_info(type_name.c_str());
             if (type_info)
             {
                 return type_info;
@@ -65,7 +108,7 @@ namespace punk
                 .vtable = type_info_traits_t::get_vtable(),
                 .field_count = type_info_traits_t::get_field_count(),
                 .component_tag = type_info_traits_t::get_component_tag(),
-                .component_group = type_info_traits<component_group>::get_hash()
+                .component_group = type_info_traits<component_group>::get_type_name_hash()
             };
             type_info_ptr new_type_info { create_type_info(create_info) };
 
@@ -110,13 +153,29 @@ namespace punk
         
         template <typename T>
         Lazy<type_info_t const*> async_get_or_create_type_info()
+        {
+            // fast path, the cache is read before the first suspension point
+            auto const cache = get_cached_type_info<T>();
+            if (cache.registry_id == registry_id_)
+            {
+                co_return cache.type_info;
+            }
+
+            auto const* type_info = co_await async_get_or_create_type_info_uncached<T>();
+            // may resume on another thread, fill the cache of the current one
+            get_cached_type_info<T>() = { registry_id_, type_info };
+            co_return type_info;
+        }
+
+    private:
+        template <typename T>
+        Lazy<type_info_t const*> async_get_or_create_type_info_uncached()
         {
             using type_info_traits_t = type_info_traits<T>;
             auto const type_name = type_info_traits_t::get_type_name();
-            auto const type_name_hash = hash_memory(type_name.c_str(), type_name.length());
 
-            // query exist type info
-            auto* type_info = co_await async_get_type_info(type_name_hash);
+            // query exist type info by its full name, another type sharing the name hash never matches
+            auto* type_info = co_await async_get_type_info(type_name.c_str());
             if (type_info)
             {
                 co_return type_info;
@@ -132,7 +191,7 @@ namespace punk
                 .vtable = type_info_traits_t::get_vtable(),
                 .field_count = type_info_traits_t::get_field_count(),
                 .component_tag = type_info_traits_t::get_component_tag(),
-                .component_group = type_info_traits<component_group>::get_hash()
+                .component_group = type_info_traits<component_group>::get_type_name_hash()
             };
             type_info_ptr new_type_info { create_type_info(create_info) };
 
@@ -187,6 +246,15 @@ namespace punk
         (reflectable<Args> && ...);
     };
 
+    // counters of the archetype registry, summed over its shards
+    struct archetype_registry_stats_t
+    {
+        uint64_t    archetype_count;
+        uint64_t    lock_acquisitions;
+        uint64_t    lock_contentions;       // acquisitions that found the shard lock taken
+        uint64_t    table_rebuilds;         // shard tables grown or compacted by writers
+    };
+
     class archetype_registry_t
     {
     protected:
@@ -204,10 +272,27 @@ namespace punk
         static archetype_registry_t* create_instance(runtime_type_registry_t* rtt_system);
 
     public:
-        virtual archetype_ptr get_archetype(uint32_t hash) = 0;
+        // lookups by archetype_t::hash alone, for hashes taken from a live archetype
+        // two signatures sharing the 64-bit hash make them ambiguous, debug builds assert on it
+        // get_or_create_archetype compares the full signature & is always exact
+        virtual archetype_ptr get_archetype(uint64_t hash) = 0;
+
+        // hot path lookup, no reference count traffic, the handle is valid while the guard from pin() is held
+        virtual archetype_handle_t find_archetype_handle(uint64_t hash) = 0;
+
+        // every live archetype, in no particular order
+        virtual void for_each_archetype(std::function<void(archetype_ptr const&)> const& func) = 0;
+
+        // contention counters, e.g. for a multi-instance level load
+        virtual archetype_registry_stats_t get_stats() const = 0;
+        virtual void reset_stats() = 0;
+
+        // archetypes are reclaimed through an epoch domain, raw handles stay valid while pinned
+        [[nodiscard]] epoch_domain::guard pin() const noexcept { return archetype_epoch_.pin(); }
 
         // runtime version of interfaces
         archetype_ptr get_or_create_archetype(type_info_t const** component_types, size_t component_count);
+        // include_orders, when given, receives the column of every requested component in the result
         archetype_ptr archetype_include_components(archetype_ptr const& archetype, size_t component_count, type_info_t const** component_types, uint32_t* include_orders = nullptr);
         archetype_ptr archetype_exclude_components(archetype_ptr const& archetype, type_info_t const** component_types, size_t component_count);
 
@@ -215,35 +300,33 @@ namespace punk
         template <typename ... Args> requires atleast_one_component_types<Args...>
         archetype_ptr get_or_create_archetype()
         {
+            static_assert(!(is_sparse_component_v<Args> || ...), "sparse components live in a sparse_storage, not in chunks");
             assert(runtime_type_registry_);
 
             // collect all runtime type information
             constexpr size_t count = sizeof...(Args);
             std::array<type_info_t const*, count> type_infos = { runtime_type_registry_->get_or_create_type_info<Args>() ... };
 
-            // sort types by hash
-            std::stable_sort(type_infos.begin(), type_infos.end(),
-                [](auto const* lhs, auto const* rhs)
-                {
-                    return get_type_hash(lhs) < get_type_hash(rhs);
-                });
+            // sort types into signature order
+            std::stable_sort(type_infos.begin(), type_infos.end(), type_info_less);
             return get_or_create_archetype_impl(type_infos.data(), count);
         }
 
         template <typename ... Args> requires atleast_one_component_types<Args...>
-        auto archetype_include_components(archetype_ptr const& archetype) -> std::pair<archetype_ptr, std::array<size_t, sizeof...(Args)>>
+        auto archetype_include_components(archetype_ptr const& archetype) -> std::pair<archetype_ptr, std::array<uint32_t, sizeof...(Args)>>
         {
+            static_assert(!(is_sparse_component_v<Args> || ...), "sparse components live in a sparse_storage, not in chunks");
             assert(runtime_type_registry_);
             constexpr size_t component_count = sizeof...(Args);
 
             // prepare component types
             std::array<type_info_t const*, component_count> component_types
             {
-                (runtime_type_registry_->get_or_create_type_info<Args>(), ...)
+                runtime_type_registry_->get_or_create_type_info<Args>()...
             };
 
             // prepare order
-            std::array<size_t, component_count> orders{};
+            std::array<uint32_t, component_count> orders{};
 
             // forward to runtime interface
             auto result_archetype = archetype_include_components(archetype, component_count, component_types.data(), orders.data());
@@ -259,19 +342,19 @@ namespace punk
             constexpr size_t component_count = sizeof...(Args);
             std::array<type_info_t const*, component_count> component_types
             {
-                (runtime_type_registry_->get_or_create_type_info<Args>(), ...)
+                runtime_type_registry_->get_or_create_type_info<Args>()...
             };
             return archetype_exclude_components(archetype, component_types.data(), component_count);
         }
 
     protected:
         virtual archetype_ptr get_or_create_archetype_impl(type_info_t const** sorted_component_types, size_t component_count) = 0;
-        virtual archetype_ptr archetype_include_components_impl(archetype_ptr const& archetype, 
-            size_t component_count, type_info_t const** component_types, uint32_t* include_orders) = 0;
-        virtual archetype_ptr archetype_exclude_components_impl(archetype_ptr const& archetype, type_info_t const** component_types, size_t component_count) = 0;
+        virtual archetype_ptr archetype_include_components_impl(archetype_ptr const& archetype, type_info_t const** sorted_component_types, size_t component_count) = 0;
+        virtual archetype_ptr archetype_exclude_components_impl(archetype_ptr const& archetype, type_info_t const** sorted_component_types, size_t component_count) = 0;
 
     protected:
         runtime_type_registry_t* runtime_type_registry_;
+        mutable epoch_domain     archetype_epoch_;
     };
 
     // archetype instance handle
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <atomic>
+#include "ECS/Detail/Meta.h"
+#include "ECS/Detail/RTTI.h"
+#include "ECS/Detail/View.h"
+
+namespace punk
+{
+    // per world singletons (clock, rng, config, spatial index) stored outside chunks, one object per type_info_t
+    // a type gets its slot index when registered or first emplaced, typed access goes through a per thread cached index
+    // lookups never create slots, any number of systems may read concurrently
+    // register_resource, emplace & erase are structural changes, they must not run concurrently with access
+    class resource_registry_t
+    {
+    private:
+        struct resource_slot_t
+        {
+            type_info_t const*  type;
+            void*               object;
+            void                (*deleter)(void*);
+        };
+
+        // per type & per thread cache of the slot index, tagged with the registry id like the type info cache
+        struct cached_resource_index_t
+        {
+            uint64_t            registry_id = 0;
+            uint32_t            index = invalid_index_value();
+        };
+
+        template <typename T>
+        static cached_resource_index_t& get_cached_resource_index() noexcept
+        {
+            thread_local cached_resource_index_t cache{};
+            return cache;
+        }
+
+        static uint64_t allocate_registry_id() noexcept
+        {
+            static std::atomic<uint64_t> next_registry_id{ 1 };
+            return next_registry_id.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        uint64_t const                                  registry_id_ = allocate_registry_id();
+        runtime_type_registry_t*                        runtime_type_registry_;
+        vector<resource_slot_t>                         slots_;
+        unordered_map<type_info_t const*, uint32_t>     slot_indices_;
+        // slots of the live resources in creation order, destroyed in reverse
+        vector<uint32_t>                                creation_order_;
+
+    public:
+        explicit resource_registry_t(runtime_type_registry_t* runtime_type_registry)
+            : runtime_type_registry_(runtime_type_registry)
+        {
+            assert(runtime_type_registry_);
+        }
+
+        ~resource_registry_t()
+        {
+            clear();
+        }
+
+        resource_registry_t(resource_registry_t const&) = delete;
+        resource_registry_t& operator=(resource_registry_t const&) = delete;
+        resource_registry_t(resource_registry_t&&) = delete;
+        resource_registry_t& operator=(resource_registry_t&&) = delete;
+
+    public: // typed interface
+        // creates the slot of T without a value, accessors resolved afterwards see later values through it
+        template <typename T>
+        uint32_t register_resource()
+        {
+            auto const index = get_or_create_slot(runtime_type_registry_->get_or_create_type_info<T>());
+            get_cached_resource_index<T>() = { registry_id_, index };
+            return index;
+        }
+
+        // constructs the resource of type T, an existing one is destroyed first
+        template <typename T, typename ... Args>
+        T& emplace(Args&& ... args)
+        {
+            auto const index = register_resource<T>();
+            auto& slot = slots_[index];
+            reset_slot(index);
+            auto* object = new T(std::forward<Args>(args)...);
+            slot.object = object;
+            slot.deleter = [](void* resource) { delete static_cast<T*>(resource); };
+            creation_order_.push_back(index);
+            return *object;
+        }
+
+        // nullptr when T has no value
+        template <typename T>
+        T* find()
+        {
+            return static_cast<T*>(get(find_resource_index<T>()));
+        }
+
+        template <typename T>
+        T const* find() const
+        {
+            return static_cast<T const*>(get(find_resource_index<T>()));
+        }
+
+        template <typename T>
+        bool erase()
+        {
+            auto const index = find_resource_index<T>();
+            auto const existed = get(index) != nullptr;
+            if(existed)
+            {
+                reset_slot(index);
+            }
+            return existed;
+        }
+
+        // slot of T, invalid_index_value() until T is registered or emplaced, stable afterwards
+        template <typename T>
+        uint32_t find_resource_index() const
+        {
+            auto& cache = get_cached_resource_index<T>();
+            if(cache.registry_id == registry_id_)
+            {
+                return cache.index;
+            }
+
+            // only hits are cached, a slot created later must still be found
+            auto const itr = slot_indices_.find(runtime_type_registry_->get_or_create_type_info<T>());
+            if(itr == slot_indices_.end())
+            {
+                return invalid_index_value();
+            }
+            cache = { registry_id_, itr->second };
+            return itr->second;
+        }
+
+    public: // runtime interface
+        // nullptr when the type has no resource
+        void* find(type_info_t const* type) const noexcept
+        {
+            auto const itr = slot_indices_.find(type);
+            return itr != slot_indices_.end() ? slots_[itr->second].object : nullptr;
+        }
+
+        void* get(uint32_t index) const noexcept
+        {
+            return index < slots_.size() ? slots_[index].object : nullptr;
+        }
+
+        // func(type_info_t const*, void*) for every live resource
+        template <typename Func>
+        void for_each(Func&& func) const
+        {
+            for(auto const& slot : slots_)
+            {
+                if(slot.object)
+                {
+                    func(slot.type, slot.object);
+                }
+            }
+        }
+
+        void clear() noexcept
+        {
+            // reverse creation order, later resources may refer to earlier ones
+            while(!creation_order_.empty())
+            {
+                reset_slot(creation_order_.back());
+            }
+        }
+
+    private:
+        uint32_t get_or_create_slot(type_info_t const* type)
+        {
+            assert(type);
+            auto const [itr, inserted] = slot_indices_.try_emplace(type, static_cast<uint32_t>(slots_.size()));
+            if(inserted)
+            {
+                slots_.push_back({ type, nullptr, nullptr });
+            }
+            return itr->second;
+        }
+
+        void reset_slot(uint32_t index) noexcept
+        {
+            auto& slot = slots_[index];
+            if(slot.object)
+            {
+                slot.deleter(slot.object);
+                slot.object = nullptr;
+                std::erase(creation_order_, index);
+            }
+        }
+    };
+
+    // typed access to a set of resources, resources<clock_t const, rng_t> reads the clock & writes the rng
+    // declares its access like view does, so the scheduler orders systems over components & resources alike
+    template <typename ... Args> requires (sizeof...(Args) > 0)
+    class resources
+    {
+    public:
+        static constexpr size_t resource_count = sizeof...(Args);
+
+        template <typename T>
+        static constexpr bool contains = (std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Args>> || ...);
+
+        template <typename T> requires contains<T>
+        static constexpr bool is_read_only = ((std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Args>> && std::is_const_v<Args>) || ...);
+
+        template <typename T>
+        static constexpr bool writes = ((std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Args>> && !std::is_const_v<Args>) || ...);
+
+        template <typename Other>
+        static constexpr bool conflicts_with() noexcept
+        {
+            return (Other::template writes<Args> || ...) || ((!std::is_const_v<Args> && Other::template contains<Args>) || ...);
+        }
+
+    private:
+        resource_registry_t*                            resource_registry_;
+        std::array<uint32_t, resource_count>            indices_;
+        std::array<type_info_t const*, resource_count>  types_;
+
+    public:
+        // read only, resources not registered yet are resolved again on access
+        resources(resource_registry_t* resource_registry, runtime_type_registry_t* runtime_type_registry)
+            : resource_registry_(resource_registry)
+            , indices_{ resource_registry->find_resource_index<std::remove_const_t<Args>>()... }
+            , types_{ runtime_type_registry->get_or_create_type_info<std::remove_const_t<Args>>()... }
+        {
+        }
+
+    public:
+        std::array<component_access_t, resource_count> get_access() const noexcept
+        {
+            size_t index = 0;
+            std::array<component_access_t, resource_count> access{};
+            ((access[index] = component_access_t{ types_[index], std::is_const_v<Args> }, ++index), ...);
+            return access;
+        }
+
+        // a const T when declared read only, nullptr when the resource is missing
+        template <typename T> requires contains<T>
+        auto* find() const
+        {
+            using declared_type = std::tuple_element_t<index_of<T>(), std::tuple<Args...>>;
+            auto const index = indices_[index_of<T>()];
+            return static_cast<declared_type*>(index != invalid_index_value()
+                ? resource_registry_->get(index)
+                : resource_registry_->find<std::remove_const_t<T>>());
+        }
+
+        template <typename T> requires contains<T>
+        auto& get() const
+        {
+            auto* resource = find<T>();
+            assert(resource && "resource does not exist");
+            return *resource;
+        }
+
+    private:
+        template <typename T>
+        static constexpr size_t index_of() noexcept
+        {
+            constexpr std::array<bool, resource_count> matches{ std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Args>>... };
+            for(size_t index = 0; index < resource_count; ++index)
+            {
+                if(matches[index])
+                {
+                    return index;
+                }
+            }
+            return resource_count;
+        }
+    };
+}
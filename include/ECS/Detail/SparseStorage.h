@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Base/Types.h"
+#include "ECS/Detail/Entity.h"
+#include "ECS/Detail/TypeInfoTraits.h"
+#include <span>
+#include <assert.h>
+
+#ifndef PUNK_SPARSE_STORAGE_PAGE_SIZE
+#define PUNK_SPARSE_STORAGE_PAGE_SIZE 4096
+#endif
+
+namespace punk
+{
+    // sparse set storage for components selected with `using component_storage = sparse_storage_tag;`
+    //  dense   : entities & values packed together, iteration touches only present components
+    //  sparse  : entity handle -> dense index, paged so unused handle ranges cost nothing
+    // adding or removing a value never changes the archetype of the entity, so toggling does not fragment chunks
+    template <typename T>
+    class sparse_storage
+    {
+    public:
+        using value_type = T;
+        static constexpr uint32_t page_size = PUNK_SPARSE_STORAGE_PAGE_SIZE;
+        static constexpr uint32_t npos = (std::numeric_limits<uint32_t>::max)();
+        static_assert(std::has_single_bit(page_size), "page size must be a power of two");
+
+    private:
+        using page_t = std::array<uint32_t, page_size>;
+
+        vector<entity_t>                        dense_entities_;
+        vector<T>                               dense_values_;
+        vector<std::unique_ptr<page_t>>         sparse_pages_;
+
+    public:
+        sparse_storage() = default;
+        sparse_storage(sparse_storage const&) = delete;
+        sparse_storage& operator=(sparse_storage const&) = delete;
+        sparse_storage(sparse_storage&&) noexcept = default;
+        sparse_storage& operator=(sparse_storage&&) noexcept = default;
+
+    public: // capacity
+        size_t size() const noexcept { return dense_entities_.size(); }
+        bool empty() const noexcept { return dense_entities_.empty(); }
+
+    public: // lookup
+        // a stale entity whose handle was reused never matches
+        T* find(entity_t entity) noexcept
+        {
+            auto const index = dense_index(entity);
+            return index != npos ? &dense_values_[index] : nullptr;
+        }
+
+        T const* find(entity_t entity) const noexcept
+        {
+            return const_cast<sparse_storage*>(this)->find(entity);
+        }
+
+        bool contains(entity_t entity) const noexcept
+        {
+            return dense_index(entity) != npos;
+        }
+
+        std::span<entity_t const> entities() const noexcept { return dense_entities_; }
+        std::span<T> values() noexcept { return dense_values_; }
+        std::span<T const> values() const noexcept { return dense_values_; }
+
+    public: // modifiers
+        // constructs the value of entity, an existing value is replaced
+        // so is the entry of an older version of the handle, the stale entity is gone afterwards
+        template <typename ... Args>
+        T& emplace(entity_t entity, Args&& ... args)
+        {
+            assert(entity.is_valid());
+            auto& slot = sparse_slot(entity.get_handle().get_value());
+            if(slot != npos)
+            {
+                dense_entities_[slot] = entity;
+                dense_values_[slot] = T{ std::forward<Args>(args)... };
+                return dense_values_[slot];
+            }
+
+            dense_values_.emplace_back(std::forward<Args>(args)...);
+            slot = static_cast<uint32_t>(dense_entities_.size());
+            dense_entities_.push_back(entity);
+            return dense_values_.back();
+        }
+
+        // removes the value of entity, the last value fills the hole
+        bool erase(entity_t entity)
+        {
+            auto const index = dense_index(entity);
+            if(index == npos)
+            {
+                return false;
+            }
+
+            auto const last = static_cast<uint32_t>(dense_entities_.size() - 1);
+            if(index != last)
+            {
+                dense_entities_[index] = dense_entities_[last];
+                dense_values_[index] = std::move(dense_values_[last]);
+                sparse_slot(dense_entities_[index].get_handle().get_value()) = index;
+            }
+            sparse_slot(entity.get_handle().get_value()) = npos;
+            dense_entities_.pop_back();
+            dense_values_.pop_back();
+            return true;
+        }
+
+        void clear() noexcept
+        {
+            dense_entities_.clear();
+            dense_values_.clear();
+            sparse_pages_.clear();
+        }
+
+    private:
+        uint32_t dense_index(entity_t entity) const noexcept
+        {
+            auto const handle = entity.get_handle().get_value();
+            auto const page = handle / page_size;
+            if(page >= sparse_pages_.size() || !sparse_pages_[page])
+            {
+                return npos;
+            }
+
+            auto const index = (*sparse_pages_[page])[handle % page_size];
+            return index != npos && dense_entities_[index].get_value() == entity.get_value() ? index : npos;
+        }
+
+        uint32_t& sparse_slot(uint32_t handle)
+        {
+            auto const page = handle / page_size;
+            if(page >= sparse_pages_.size())
+            {
+                sparse_pages_.resize(page + 1);
+            }
+            if(!sparse_pages_[page])
+            {
+                sparse_pages_[page] = std::make_unique<page_t>();
+                sparse_pages_[page]->fill(npos);
+            }
+            return (*sparse_pages_[page])[handle % page_size];
+        }
+    };
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "ECS/Detail/ChunkLayout.h"
+#include "ECS/Detail/Meta.h"
+#include "ECS/Detail/TypeInfoTraits.h"
+
+namespace punk
+{
+    template <typename T>
+    concept static_component_type = requires
+    {
+        // the registry sorts columns by type name hash & then by name, both must be known at compile time
+        { std::integral_constant<uint32_t, type_info_traits<T>::get_type_name_hash()>{} };
+        requires type_info_traits<T>::get_type_name_hash() == hash_memory(get_static_type_name<T>());
+    };
+
+    // chunk layout of an archetype whose components are known at compile time
+    // columns are sorted like type_info_less & placed by compute_chunk_layout, exactly as the archetype registry
+    // does at runtime, so typed access compiles down to fixed offsets from the chunk base
+    template <typename ... Args> requires (sizeof...(Args) > 0 && (static_component_type<Args> && ...))
+    struct static_archetype
+    {
+        static constexpr size_t component_count = sizeof...(Args);
+
+    private:
+        static constexpr std::array<uint32_t, component_count> component_hashes{ type_info_traits<Args>::get_type_name_hash()... };
+        static constexpr std::array<std::string_view, component_count> component_names{ get_static_type_name<Args>()... };
+        static constexpr std::array<uint32_t, component_count> component_sizes{ component_column_size_v<Args>... };
+        static constexpr std::array<uint32_t, component_count> component_alignments{ static_cast<uint32_t>(alignof(Args))... };
+        static constexpr std::array<bool, component_count> component_shared{ is_shared_component_v<Args>... };
+        static constexpr std::array<bool, component_count> component_enableable{ is_enableable_component_v<Args>... };
+        static constexpr uint32_t enable_mask_count = static_cast<uint32_t>(std::ranges::count(component_enableable, true));
+
+        // sorted column -> index in Args
+        static constexpr auto sorted_components = []()
+        {
+            // type_info_less at compile time
+            auto const component_less = [](uint32_t lhs, uint32_t rhs)
+            {
+                return component_hashes[lhs] != component_hashes[rhs]
+                    ? component_hashes[lhs] < component_hashes[rhs]
+                    : component_names[lhs] < component_names[rhs];
+            };
+
+            std::array<uint32_t, component_count> order{};
+            for(uint32_t index = 0; index < component_count; ++index)
+            {
+                order[index] = index;
+            }
+            // insertion sort, stable like the runtime one
+            for(size_t index = 1; index < component_count; ++index)
+            {
+                for(auto current = index; current > 0 && component_less(order[current], order[current - 1]); --current)
+                {
+                    std::swap(order[current], order[current - 1]);
+                }
+            }
+            return order;
+        }();
+
+        struct layout_t
+        {
+            std::array<uint32_t, component_count>   offsets{};
+            uint32_t                                capacity = 0;
+            uint32_t                                enable_masks_offset = 0;
+            uint32_t                                entities_offset = 0;
+        };
+
+        static constexpr layout_t layout = []()
+        {
+            std::array<uint32_t, component_count> sizes{};
+            std::array<uint32_t, component_count> alignments{};
+            std::array<bool, component_count> shared{};
+            for(size_t column = 0; column < component_count; ++column)
+            {
+                sizes[column] = component_sizes[sorted_components[column]];
+                alignments[column] = component_alignments[sorted_components[column]];
+                shared[column] = component_shared[sorted_components[column]];
+            }
+
+            layout_t result{};
+            result.capacity = compute_chunk_layout(sizes.data(), alignments.data(), component_count, result.offsets.data(),
+                shared.data(), enable_mask_count, &result.enable_masks_offset, &result.entities_offset);
+            return result;
+        }();
+
+        template <typename T>
+        static constexpr uint32_t index_of() noexcept
+        {
+            constexpr std::array<bool, component_count> matches{ std::is_same_v<T, Args>... };
+            for(uint32_t index = 0; index < component_count; ++index)
+            {
+                if(matches[index])
+                {
+                    return index;
+                }
+            }
+            return invalid_index_value();
+        }
+
+    public:
+        static_assert(std::negation_v<tuple_has_repeated_types<Args...>>, "components of an archetype must be distinct");
+        static_assert(layout.capacity > 0, "components do not fit in one chunk");
+
+        static constexpr uint32_t capacity_in_chunk = layout.capacity;
+        static constexpr uint32_t entities_offset = layout.entities_offset;
+
+        template <typename T>
+        static constexpr bool contains = index_of<T>() != invalid_index_value();
+
+        // column of T in the registry order
+        template <typename T> requires contains<T>
+        static constexpr uint32_t column_of() noexcept
+        {
+            for(uint32_t column = 0; column < component_count; ++column)
+            {
+                if(sorted_components[column] == index_of<T>())
+                {
+                    return column;
+                }
+            }
+            return invalid_index_value();
+        }
+
+        static constexpr uint32_t offset_of_column(uint32_t column) noexcept
+        {
+            return layout.offsets[column];
+        }
+
+        template <typename T> requires contains<T>
+        static constexpr uint32_t offset_of() noexcept
+        {
+            return layout.offsets[column_of<T>()];
+        }
+
+        // enable mask of an enableable T, masks follow each other in column order like in the registry
+        template <typename T> requires (contains<T> && is_enableable_component_v<T>)
+        static constexpr uint32_t enable_mask_offset_of() noexcept
+        {
+            uint32_t offset = layout.enable_masks_offset;
+            for(uint32_t column = 0; column < column_of<T>(); ++column)
+            {
+                offset += component_enableable[sorted_components[column]] ? chunk_enable_mask_words(capacity_in_chunk) * 8 : 0;
+            }
+            return offset;
+        }
+
+        template <typename T> requires contains<T>
+        static T* column(chunk_t* chunk) noexcept
+        {
+            return reinterpret_cast<T*>(reinterpret_cast<std::byte*>(chunk) + offset_of<T>());
+        }
+
+        template <typename T> requires contains<T>
+        static T& get(chunk_t* chunk, uint32_t row) noexcept
+        {
+            assert(row < capacity_in_chunk);
+            return column<T>(chunk)[row_in_column<T>(row)];
+        }
+
+        // shared components keep a single value per chunk
+        template <typename T>
+        static constexpr uint32_t row_in_column(uint32_t row) noexcept
+        {
+            return is_shared_component_v<T> ? 0 : row;
+        }
+
+        // func(Args&...) for the first row_count rows of a chunk
+        template <typename Func>
+        static void for_each(chunk_t* chunk, uint32_t row_count, Func&& func)
+        {
+            assert(row_count <= capacity_in_chunk);
+            std::tuple<Args*...> columns{ column<Args>(chunk)... };
+            for(uint32_t row = 0; row < row_count; ++row)
+            {
+                std::apply([&](Args* ... column_ptrs) { func(column_ptrs[row_in_column<Args>(row)]...); }, columns);
+            }
+        }
+    };
+}
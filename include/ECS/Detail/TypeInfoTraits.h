@@ -3,6 +3,7 @@
 #include <format>
 #include "Base/Reflection/TypeTraitsExt.h"
 #include "Base/Reflection/TypeDemangle.h"
+#include "Base/Reflection/TypeName.h"
 #include "Base/Utils/Hash.h"
 #include "Base/Math/Math.h"
 #include "Base/Reflection/StaticReflection.h"
@@ -16,6 +17,40 @@ namespace punk
 
     struct data_component_tag{};
     struct cow_component_tag{};
+    // one value per chunk instead of per row, chunks are partitioned by the value
+    struct shared_component_tag{};
+    // per row data with a per chunk enable bit, toggling never moves the entity to another archetype
+    struct enableable_component_tag{};
+
+    // where a component lives, selected with `using component_storage = ...;` next to component_tag
+    // chunk storage is the default, sparse components stay out of archetype signatures & live in a sparse_storage
+    struct chunk_storage_tag{};
+    struct sparse_storage_tag{};
+
+    // moving an object to a new address & dropping the old one is a memcpy
+    // specialize for types that are not trivially copyable but never keep pointers into themselves
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    // empty components are tags, an archetype records them in its signature without a column
+    template <typename T>
+    inline constexpr bool is_tag_component_v = std::is_empty_v<T>;
+
+    template <typename T>
+    inline constexpr bool is_shared_component_v = std::is_same_v<traits_component_tag_t<T>, shared_component_tag>;
+
+    template <typename T>
+    inline constexpr bool is_enableable_component_v = std::is_same_v<traits_component_tag_t<T>, enableable_component_tag>;
+
+    template <typename T>
+    inline constexpr bool is_sparse_component_v = std::is_same_v<traits_component_storage_t<T>, sparse_storage_tag>;
+
+    // bytes one value of a component takes in a chunk
+    template <typename T>
+    inline constexpr uint32_t component_column_size_v = is_tag_component_v<T> ? 0u : static_cast<uint32_t>(sizeof(T));
 }
 
 // for primative types
@@ -33,7 +68,7 @@ namespace punk
 
         static std::string get_type_name()
         {
-            return get_demangle_name<type>();
+            return std::string{ get_static_type_name<type>() };
         }
 
         static constexpr uint32_t get_size() noexcept
@@ -65,27 +100,46 @@ namespace punk
             return uint32_t{ 0 };
         }
 
-        static uint32_t get_hash()
+        // hash of get_type_name(), folded at compile time
+        static constexpr uint32_t get_type_name_hash() noexcept
         {
-            auto const type_name = get_type_name();
-            return hash_memory(type_name.c_str(), type_name.length());
+            return hash_memory(get_static_type_name<type>());
         }
 
         static constexpr auto get_vtable() noexcept -> type_vtable_t
         {
-            type_vtable_t vtable = { nullptr, nullptr, nullptr, nullptr, nullptr };
+            type_vtable_t vtable{};
+            vtable.trivially_copyable = std::is_trivially_copyable_v<T>;
+            vtable.trivially_relocatable = is_trivially_relocatable_v<T>;
+            vtable.empty = is_tag_component_v<T>;
 
             if constexpr(std::negation_v<std::is_trivially_constructible<T>>)
             {
                 vtable.constructor = [](void* addr) { new (addr) T{}; };
+                vtable.construct_n = [](void* addr, size_t count) { std::uninitialized_value_construct_n(reinterpret_cast<T*>(addr), count); };
             }
 
             if constexpr(std::negation_v<std::is_trivially_destructible<T>>)
             {
                 vtable.destructor = [](void* addr) { reinterpret_cast<T*>(addr)->~T(); };
+                vtable.destroy_n = [](void* addr, size_t count) { std::destroy_n(reinterpret_cast<T*>(addr), count); };
+            }
+
+            if constexpr(std::negation_v<std::is_trivially_copyable<T>>)
+            {
                 vtable.copy_func = [](void* dst, void const* src) { *reinterpret_cast<T*>(dst) = *reinterpret_cast<T const*>(src); };
                 vtable.swap_func = [](void* lhs, void* rhs) { std::swap(*reinterpret_cast<T*>(lhs), *reinterpret_cast<T*>(rhs)); };
-                vtable.move_func = [](void* dst, void* src) { *reinterpret_cast<T*>(dst) = std::move(*reinterpret_cast<T const*>(src)); };
+                vtable.move_func = [](void* dst, void* src) { *reinterpret_cast<T*>(dst) = std::move(*reinterpret_cast<T*>(src)); };
+                vtable.copy_n = [](void* dst, void const* src, size_t count) { std::copy_n(reinterpret_cast<T const*>(src), count, reinterpret_cast<T*>(dst)); };
+            }
+
+            if constexpr(std::negation_v<is_trivially_relocatable<T>>)
+            {
+                vtable.relocate_n = [](void* dst, void* src, size_t count)
+                {
+                    std::uninitialized_move_n(reinterpret_cast<T*>(src), count, reinterpret_cast<T*>(dst));
+                    std::destroy_n(reinterpret_cast<T*>(src), count);
+                };
             }
 
             return vtable;
@@ -100,6 +154,16 @@ namespace punk
                 {
                     return component_tag_t::data;
                 }
+                else if constexpr(std::is_same_v<component_tag, shared_component_tag>)
+                {
+                    // chunks are partitioned by comparing the stored bytes
+                    static_assert(std::is_trivially_copyable_v<type>, "shared components must be trivially copyable");
+                    return component_tag_t::shared;
+                }
+                else if constexpr(std::is_same_v<component_tag, enableable_component_tag>)
+                {
+                    return component_tag_t::enableable;
+                }
                 else
                 {
                     static_assert(std::is_same_v<component_tag, cow_component_tag>);
@@ -124,6 +188,10 @@ namespace punk
         {                                                                   \
             return #TypeName;                                               \
         }                                                                   \
+        static constexpr uint32_t get_type_name_hash() noexcept             \
+        {                                                                   \
+            return hash_memory(#TypeName);                                  \
+        }                                                                   \
     }
 
     PUNK_IMPLEMENT_PRIMATIVE_TYPE(bool, bool);
@@ -158,6 +226,11 @@ namespace punk
             using value_type_info = type_info_traits<T>;
             return std::format("std::array<{}, {}>", value_type_info::get_type_name(), Size);
         }
+
+        static uint32_t get_type_name_hash()
+        {
+            return hash_memory(get_type_name());
+        }
     };
 
     template <typename T>
@@ -170,6 +243,11 @@ namespace punk
             using value_type_info = type_info_traits<T>;
             return std::format("std::vector<{}>", value_type_info::get_type_name());
         }
+
+        static uint32_t get_type_name_hash()
+        {
+            return hash_memory(get_type_name());
+        }
     };
 
     template <typename Key, typename Value>
@@ -183,6 +261,11 @@ namespace punk
             using value_type_info = type_info_traits<Value>;
             return std::format("std::map<{}, {}>", key_type_info::get_type_info(), value_type_info::get_type_name());
         }
+
+        static uint32_t get_type_name_hash()
+        {
+            return hash_memory(get_type_name());
+        }
     };
 
     template <typename Key, typename Value>
@@ -196,6 +279,11 @@ namespace punk
             using value_type_info = type_info_traits<Value>;
             return std::format("std::unordered_map<{}, {}>", key_type_info::get_type_info(), value_type_info::get_type_name());
         }
+
+        static uint32_t get_type_name_hash()
+        {
+            return hash_memory(get_type_name());
+        }
     };
 }
 
@@ -219,11 +307,17 @@ namespace punk::detail
         using seq_tuple = tuple_remove_cvref_t<tied_tuple>;
         using offset_getter_check_type = boost::pfr::detail::offset_based_getter<T, seq_tuple>;
 
+        // fields in declaration order at their natural alignment, the layout offset_based_getter relies on
+        // computed from sizes & alignments, subtracting pointers to different members is not a constant expression
         template <size_t idx>
         static constexpr size_t offset() noexcept {
-            constexpr boost::pfr::detail::tuple_of_aligned_storage_t<seq_tuple> layout{};
-            return static_cast<size_t>(&boost::pfr::detail::sequence_tuple::get<idx>(layout).storage_[0]
-                - &boost::pfr::detail::sequence_tuple::get<0>(layout).storage_[0]);
+            return []<size_t ... Indices>(std::index_sequence<Indices...>)
+            {
+                size_t offset = 0;
+                ((offset = align_up(offset, alignof(boost::pfr::tuple_element_t<Indices, T>))
+                    + (Indices < idx ? sizeof(boost::pfr::tuple_element_t<Indices, T>) : 0)), ...);
+                return offset;
+            }(std::make_index_sequence<idx + 1>{});
         }
     };
 }
@@ -246,7 +340,7 @@ namespace punk
         static constexpr auto get_field_type() noexcept -> tuple_element_t<I, type>;
 
         template <size_t I>
-        static /*constexpr*/ uint32_t get_field_offset() noexcept
+        static constexpr uint32_t get_field_offset() noexcept
         {
             return static_cast<uint32_t>(std::get<I>(reflect_info_t::member_offsets()));
         }
@@ -266,7 +360,7 @@ namespace punk
         static constexpr auto get_field_type() noexcept -> boost::pfr::tuple_element_t<I, type>;
 
         template <size_t I>
-        static /*constexpr*/ uint32_t get_field_offset() noexcept
+        static constexpr uint32_t get_field_offset() noexcept
         {
             using offset_getter = detail::pfr_offset_getter<type>;
             return static_cast<uint32_t>(offset_getter::template offset<I>());
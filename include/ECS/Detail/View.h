@@ -0,0 +1,473 @@
+#pragma once
+
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <span>
+#include <variant>
+#include "Base/Containers/Detail/BitsetKernels.h"
+#include "ECS/Detail/ChunkLayout.h"
+#include "ECS/Detail/Meta.h"
+#include "ECS/Detail/RTTI.h"
+#include "ECS/Detail/SparseStorage.h"
+
+namespace punk
+{
+    // how a view touches one component, used by the scheduler to order systems
+    struct component_access_t
+    {
+        type_info_t const*          type;
+        bool                        read_only;
+    };
+
+    // how many chunks of a view reached per row work & which chunk filter ruled out the others
+    struct view_stats_t
+    {
+        uint64_t                    chunks_visited = 0;
+        uint64_t                    chunks_skipped_changed = 0;
+        uint64_t                    chunks_skipped_shared = 0;
+        uint64_t                    chunks_skipped_predicate = 0;
+        uint64_t                    chunks_skipped_enabled = 0;
+    };
+
+    // typed iteration over the chunks of matching archetypes, view<A const, B> reads A & writes B
+    // column offsets are resolved once per archetype & base pointers once per chunk,
+    // the user gets plain spans so inner loops carry no per entity lookups
+    // a shared component comes as a one element span, shared filters skip whole chunks
+    // for_each only visits rows whose enableable components are all enabled, for_each_chunk hands out every row
+    // sparse components are looked up in the bound sparse_storage, only for_each can join them
+    // chunk filters (changed since, shared value, user predicate, enabled rows) run before any per row work
+    template <typename ... Args> requires atleast_one_component_types<std::remove_const_t<Args>...>
+    class view
+    {
+    public:
+        static constexpr size_t component_count = sizeof...(Args);
+
+        template <typename T>
+        static constexpr bool contains = (std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Args>> || ...);
+
+        // components the view only reads
+        template <typename T> requires contains<T>
+        static constexpr bool is_read_only = ((std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Args>> && std::is_const_v<Args>) || ...);
+
+        // components the view writes
+        template <typename T>
+        static constexpr bool writes = ((std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Args>> && !std::is_const_v<Args>) || ...);
+
+        template <typename T>
+        static constexpr bool is_shared = is_shared_component_v<std::remove_const_t<T>>;
+
+        template <typename T>
+        static constexpr bool is_enableable = is_enableable_component_v<std::remove_const_t<T>>;
+
+        static constexpr bool has_enableable = (is_enableable<Args> || ...);
+
+        template <typename T>
+        static constexpr bool is_sparse = is_sparse_component_v<std::remove_const_t<T>>;
+
+        static constexpr bool has_sparse = (is_sparse<Args> || ...);
+
+        // two views can run concurrently unless one writes a component the other touches
+        template <typename OtherView>
+        static constexpr bool conflicts_with() noexcept
+        {
+            return (OtherView::template writes<Args> || ...) || ((!std::is_const_v<Args> && OtherView::template contains<Args>) || ...);
+        }
+
+    private:
+        // the value a chunk must hold for a shared component, nothing for the per row ones
+        template <typename T>
+        using shared_filter_t = std::conditional_t<is_shared<T>, std::optional<std::remove_const_t<T>>, std::monostate>;
+
+        template <typename T>
+        using sparse_binding_t = std::conditional_t<is_sparse<T>, sparse_storage<std::remove_const_t<T>>*, std::monostate>;
+
+        std::array<type_info_t const*, component_count>     component_types_;
+        std::tuple<shared_filter_t<Args>...>                shared_filters_;
+        std::tuple<sparse_binding_t<Args>...>               sparse_storages_;
+
+        // columns of the last matched archetype, consecutive chunks usually share it
+        archetype_handle_t                                  cached_archetype_{};
+        uint64_t                                            cached_archetype_hash_ = 0;
+        bool                                                cached_match_ = false;
+        std::array<uint32_t, component_count>               cached_offsets_{};
+        std::array<uint32_t, component_count>               cached_enable_mask_offsets_{};
+        std::array<uint32_t, component_count>               cached_change_version_offsets_{};
+        uint32_t                                            cached_entities_offset_ = 0;
+
+        // chunk filters & their results
+        std::array<bool, component_count>                   changed_filters_{};
+        uint32_t                                            changed_since_ = 0;
+        uint32_t                                            write_version_ = 0;
+        std::function<bool(chunk_t const*)>                 chunk_predicate_;
+        view_stats_t                                        stats_;
+        bool                                                visited_last_chunk_ = false;
+
+    public:
+        explicit view(runtime_type_registry_t* runtime_type_registry)
+            : component_types_{ runtime_type_registry->get_or_create_type_info<std::remove_const_t<Args>>()... }
+        {
+        }
+
+    public:
+        std::array<component_access_t, component_count> get_access() const noexcept
+        {
+            size_t index = 0;
+            std::array<component_access_t, component_count> access{};
+            ((access[index] = component_access_t{ component_types_[index], std::is_const_v<Args> }, ++index), ...);
+            return access;
+        }
+
+        // only visit chunks whose shared T equals value
+        template <typename T> requires (contains<T> && is_shared<T>)
+        void set_shared_filter(std::remove_const_t<T> const& value)
+        {
+            std::get<index_of<T>()>(shared_filters_) = value;
+        }
+
+        void clear_shared_filters() noexcept
+        {
+            shared_filters_ = {};
+        }
+
+        // only visit chunks where any of the filtered components was written after version
+        template <typename T> requires (contains<T> && !is_sparse<T>)
+        void set_changed_filter(uint32_t version) noexcept
+        {
+            changed_filters_[index_of<T>()] = true;
+            changed_since_ = version;
+        }
+
+        void clear_changed_filters() noexcept
+        {
+            changed_filters_ = {};
+        }
+
+        // the writable columns of every visited chunk are stamped with version, 0 leaves the versions alone
+        void set_write_version(uint32_t version) noexcept
+        {
+            write_version_ = version;
+        }
+
+        // false skips the chunk, it only sees the header & must not touch rows
+        void set_chunk_predicate(std::function<bool(chunk_t const*)> predicate)
+        {
+            chunk_predicate_ = std::move(predicate);
+        }
+
+        view_stats_t const& get_stats() const noexcept { return stats_; }
+        // whether the last for_each / for_each_chunk call reached per row work, false when a filter skipped the chunk
+        bool visited_last_chunk() const noexcept { return visited_last_chunk_; }
+        void reset_stats() noexcept { stats_ = {}; }
+
+        // storage the sparse T of every row is looked up in, must be bound before iterating
+        template <typename T> requires (contains<T> && is_sparse<T>)
+        void bind_sparse_storage(sparse_storage<std::remove_const_t<T>>* storage) noexcept
+        {
+            std::get<index_of<T>()>(sparse_storages_) = storage;
+        }
+
+        // resolves the columns of archetype, false when it lacks any component of the view
+        bool matches(archetype_handle_t archetype) noexcept
+        {
+            // the hash guards against a freed archetype's address being reused by another signature
+            auto const archetype_hash = get_archetype_hash(archetype.get());
+            if(archetype == cached_archetype_ && archetype_hash == cached_archetype_hash_)
+            {
+                return cached_match_;
+            }
+
+            cached_archetype_ = archetype;
+            cached_archetype_hash_ = archetype_hash;
+            cached_match_ = true;
+            cached_entities_offset_ = get_archetype_entities_offset(archetype.get());
+            constexpr std::array<bool, component_count> sparse{ is_sparse<Args>... };
+            for(size_t index = 0; index < component_count; ++index)
+            {
+                if(sparse[index])
+                {
+                    // not part of any archetype signature
+                    cached_change_version_offsets_[index] = invalid_offset_value();
+                    continue;
+                }
+
+                auto const column = find_archetype_component(archetype.get(), component_types_[index]);
+                if(column == invalid_index_value())
+                {
+                    cached_match_ = false;
+                    break;
+                }
+                cached_offsets_[index] = get_archetype_component_offset(archetype.get(), column);
+                cached_enable_mask_offsets_[index] = get_archetype_enable_mask_offset(archetype.get(), column);
+                cached_change_version_offsets_[index] = get_archetype_change_version_offset(archetype.get(), column);
+            }
+            return cached_match_;
+        }
+
+        // func(std::span<Args>...) once per chunk of archetype, returns false when the archetype does not match
+        template <typename Func> requires (!has_sparse)
+        bool for_each_chunk(archetype_handle_t archetype, chunk_t* chunk, Func&& func)
+        {
+            visited_last_chunk_ = false;
+            if(!matches(archetype))
+            {
+                return false;
+            }
+
+            auto const element_count = get_chunk_element_count(chunk);
+            if(element_count > 0 && passes_chunk_filters(chunk))
+            {
+                invoke_with_columns(chunk, element_count, func, std::index_sequence_for<Args...>{});
+                visited_chunk(chunk);
+            }
+            return true;
+        }
+
+        template <typename Func> requires (!has_sparse)
+        bool for_each_chunk(archetype_handle_t archetype, std::span<chunk_t* const> chunks, Func&& func)
+        {
+            if(!matches(archetype))
+            {
+                return false;
+            }
+
+            for(auto* chunk : chunks)
+            {
+                for_each_chunk(archetype, chunk, func);
+            }
+            return true;
+        }
+
+        // func(Args&...) per row, a tight loop over the resolved columns
+        // sparse components are joined through the entity of each row, rows missing one are skipped
+        template <typename Func>
+        bool for_each(archetype_handle_t archetype, chunk_t* chunk, Func&& func)
+        {
+            visited_last_chunk_ = false;
+            if(!matches(archetype))
+            {
+                return false;
+            }
+
+            auto const element_count = get_chunk_element_count(chunk);
+            if(element_count == 0 || !passes_chunk_filters(chunk) || !has_sparse_values())
+            {
+                return true;
+            }
+
+            auto* chunk_base = reinterpret_cast<std::byte*>(chunk);
+            auto const* entities = reinterpret_cast<entity_t const*>(chunk_base + cached_entities_offset_);
+            std::tuple<Args*...> const columns{ reinterpret_cast<std::remove_const_t<Args>*>(chunk_base + cached_offsets_[index_of<Args>()])... };
+            if constexpr(has_enableable)
+            {
+                // and the enable masks of every enableable column, then walk the set bits
+                std::array<uint64_t, chunk_enable_mask_words(chunk_size_in_bytes)> enabled;
+                auto const word_count = chunk_enable_mask_words(element_count);
+                combine_enable_masks(chunk, enabled.data(), word_count, std::index_sequence_for<Args...>{});
+                if(std::all_of(enabled.data(), enabled.data() + word_count, [](uint64_t word) { return word == 0; }))
+                {
+                    ++stats_.chunks_skipped_enabled;
+                    return true;
+                }
+
+                for(uint32_t word = 0; word < word_count; ++word)
+                {
+                    for(auto bits = enabled[word]; bits != 0; bits &= bits - 1)
+                    {
+                        auto const row = word * 64 + static_cast<uint32_t>(std::countr_zero(bits));
+                        invoke_row(func, columns, entities, row, std::index_sequence_for<Args...>{});
+                    }
+                }
+            }
+            else
+            {
+                for(uint32_t row = 0; row < element_count; ++row)
+                {
+                    invoke_row(func, columns, entities, row, std::index_sequence_for<Args...>{});
+                }
+            }
+            visited_chunk(chunk);
+            return true;
+        }
+
+    private:
+        template <typename T>
+        static constexpr size_t index_of() noexcept
+        {
+            constexpr std::array<bool, component_count> matches{ std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Args>>... };
+            for(size_t index = 0; index < component_count; ++index)
+            {
+                if(matches[index])
+                {
+                    return index;
+                }
+            }
+            return component_count;
+        }
+
+        // cheapest first, a few header loads before the memcmp of shared values & the user predicate
+        bool passes_chunk_filters(chunk_t const* chunk) noexcept
+        {
+            if(!passes_changed_filters(chunk))
+            {
+                ++stats_.chunks_skipped_changed;
+                return false;
+            }
+            if(!passes_shared_filters(chunk, std::index_sequence_for<Args...>{}))
+            {
+                ++stats_.chunks_skipped_shared;
+                return false;
+            }
+            if(chunk_predicate_ && !chunk_predicate_(chunk))
+            {
+                ++stats_.chunks_skipped_predicate;
+                return false;
+            }
+            return true;
+        }
+
+        bool passes_changed_filters(chunk_t const* chunk) const noexcept
+        {
+            auto const* chunk_base = reinterpret_cast<std::byte const*>(chunk);
+            bool filtered = false;
+            for(size_t index = 0; index < component_count; ++index)
+            {
+                // tags have no version, they never rule a chunk out
+                if(!changed_filters_[index] || cached_change_version_offsets_[index] == invalid_offset_value())
+                {
+                    continue;
+                }
+
+                uint32_t version;
+                std::memcpy(&version, chunk_base + cached_change_version_offsets_[index], sizeof(version));
+                if(version > changed_since_)
+                {
+                    return true;
+                }
+                filtered = true;
+            }
+            return !filtered;
+        }
+
+        void visited_chunk(chunk_t* chunk) noexcept
+        {
+            ++stats_.chunks_visited;
+            visited_last_chunk_ = true;
+            if(write_version_ == 0)
+            {
+                return;
+            }
+
+            constexpr std::array<bool, component_count> writable{ !std::is_const_v<Args>... };
+            auto* chunk_base = reinterpret_cast<std::byte*>(chunk);
+            for(size_t index = 0; index < component_count; ++index)
+            {
+                if(writable[index] && cached_change_version_offsets_[index] != invalid_offset_value())
+                {
+                    std::memcpy(chunk_base + cached_change_version_offsets_[index], &write_version_, sizeof(write_version_));
+                }
+            }
+        }
+
+        // an empty sparse storage rules out every row of every chunk
+        bool has_sparse_values() const noexcept
+        {
+            return std::apply([](auto const& ... bindings)
+                {
+                    auto const has_values = [](auto const& binding)
+                        {
+                            if constexpr(std::is_same_v<std::remove_cvref_t<decltype(binding)>, std::monostate>)
+                            {
+                                return true;
+                            }
+                            else
+                            {
+                                assert(binding && "sparse storage not bound");
+                                return !binding->empty();
+                            }
+                        };
+                    return (has_values(bindings) && ...);
+                }, sparse_storages_);
+        }
+
+        template <typename Func, size_t ... Indices>
+        void invoke_row(Func& func, std::tuple<Args*...> const& columns, entity_t const* entities, uint32_t row, std::index_sequence<Indices...>)
+        {
+            if constexpr(has_sparse)
+            {
+                // one probe per sparse component, rows without all of them are not part of the join
+                std::tuple<Args*...> const values{ row_value<Indices>(columns, entities, row)... };
+                if(((std::get<Indices>(values) != nullptr) && ...))
+                {
+                    func(*std::get<Indices>(values)...);
+                }
+            }
+            else
+            {
+                func(std::get<Indices>(columns)[is_shared<Args> ? 0 : row]...);
+            }
+        }
+
+        template <size_t Index>
+        auto* row_value(std::tuple<Args*...> const& columns, entity_t const* entities, uint32_t row)
+        {
+            using arg_type = std::tuple_element_t<Index, std::tuple<Args...>>;
+            if constexpr(is_sparse<arg_type>)
+            {
+                return static_cast<arg_type*>(std::get<Index>(sparse_storages_)->find(entities[row]));
+            }
+            else
+            {
+                return std::get<Index>(columns) + (is_shared<arg_type> ? 0 : row);
+            }
+        }
+
+        template <size_t ... Indices>
+        bool passes_shared_filters(chunk_t const* chunk, std::index_sequence<Indices...>) const noexcept
+        {
+            auto const* chunk_base = reinterpret_cast<std::byte const*>(chunk);
+            auto const passes = [chunk_base](auto const& filter, uint32_t offset)
+                {
+                    if constexpr(std::is_same_v<std::remove_cvref_t<decltype(filter)>, std::monostate>)
+                    {
+                        return true;
+                    }
+                    else
+                    {
+                        // chunks are partitioned by the bytes of the shared value
+                        return !filter || std::memcmp(chunk_base + offset, &*filter, sizeof(*filter)) == 0;
+                    }
+                };
+            return (passes(std::get<Indices>(shared_filters_), cached_offsets_[Indices]) && ...);
+        }
+
+        template <size_t ... Indices>
+        void combine_enable_masks(chunk_t const* chunk, uint64_t* enabled, uint32_t word_count, std::index_sequence<Indices...>) const noexcept
+        {
+            auto const* chunk_base = reinterpret_cast<std::byte const*>(chunk);
+            auto const& kernels = detail::get_bitset_kernels();
+            bool first = true;
+            auto const combine = [&](uint32_t mask_offset)
+                {
+                    auto const* mask = reinterpret_cast<uint64_t const*>(chunk_base + mask_offset);
+                    if(first)
+                    {
+                        std::copy_n(mask, word_count, enabled);
+                        first = false;
+                    }
+                    else
+                    {
+                        kernels.and_assign(enabled, mask, word_count);
+                    }
+                };
+            ((is_enableable<Args> ? combine(cached_enable_mask_offsets_[Indices]) : void()), ...);
+        }
+
+        template <typename Func, size_t ... Indices>
+        void invoke_with_columns(chunk_t* chunk, uint32_t element_count, Func&& func, std::index_sequence<Indices...>)
+        {
+            auto* chunk_base = reinterpret_cast<std::byte*>(chunk);
+            func(std::span<Args>{ reinterpret_cast<std::remove_const_t<Args>*>(chunk_base + cached_offsets_[Indices]), is_shared<Args> ? 1u : element_count }...);
+        }
+    };
+}
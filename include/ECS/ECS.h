@@ -11,4 +11,12 @@
 #include "ECS/Detail/Entity.h"
 #include "ECS/Detail/EntityPool.h"
 #include "ECS/Detail/RTTI.h"
+#include "ECS/Detail/ArchetypeManifest.h"
+#include "ECS/Detail/ChunkLayout.h"
+#include "ECS/Detail/StaticArchetype.h"
+#include "ECS/Detail/SparseStorage.h"
+#include "ECS/Detail/Hierarchy.h"
+#include "ECS/Detail/View.h"
+#include "ECS/Detail/Resources.h"
+#include "ECS/Detail/ComponentEvents.h"
 #include "ECS/Detail/DataStorage.h"
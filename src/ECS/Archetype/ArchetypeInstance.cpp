@@ -0,0 +1,365 @@
+#include "ECS/Archetype/ArchetypeInstance.h"
+
+namespace punk
+{
+    archetype_instance::~archetype_instance()
+    {
+        if(!archetype_)
+        {
+            return;
+        }
+
+        // chunk memory goes with chunk_nodes_, the rows still alive are destroyed here
+        chunk_nodes_.for_each_chunk(
+            [this](chunk_t* chunk)
+            {
+                for(uint32_t column = 0; column < archetype_->component_types.size(); ++column)
+                {
+                    auto const* component_type = archetype_->component_types[column];
+                    if(!is_shared_component(component_type))
+                    {
+                        destroy_objects(component_type, get_column(chunk, column), chunk->element_count);
+                    }
+                }
+            });
+    }
+
+    row_location_t archetype_instance::allocate_row(entity_t entity, void const* const* shared_values)
+    {
+        assert(archetype_);
+        auto const& component_types = archetype_->component_types;
+
+        auto* chunk = acquire_chunk(shared_values);
+        auto const row = chunk->element_count++;
+        get_entities(chunk)[row] = entity;
+        for(uint32_t column = 0; column < component_types.size(); ++column)
+        {
+            auto const* component_type = component_types[column];
+            if(!is_shared_component(component_type))
+            {
+                construct_objects(component_type, get_column(chunk, column) + row * get_type_size(component_type), 1);
+            }
+            if(is_enableable_component(component_type))
+            {
+                // new rows start enabled
+                set_component_enabled(chunk, row, column, true);
+            }
+        }
+        stamp_change_versions(chunk, change_version_);
+        publish_row_events(component_event_t::added, &entity, 1);
+        return { chunk, row };
+    }
+
+    uint32_t archetype_instance::free_row(chunk_t* chunk, uint32_t row)
+    {
+        assert(archetype_ && chunk && row < chunk->element_count);
+        // rows move & chunks may go away, the planned slots no longer hold
+        cancel_reorder();
+        auto const last = chunk->element_count - 1;
+        publish_row_events(component_event_t::removed, get_entities(chunk) + row, 1);
+        get_entities(chunk)[row] = get_entities(chunk)[last];
+        for(uint32_t column = 0; column < archetype_->component_types.size(); ++column)
+        {
+            auto const* component_type = archetype_->component_types[column];
+            if(is_shared_component(component_type))
+            {
+                continue;
+            }
+
+            auto const size = get_type_size(component_type);
+            auto* data = get_column(chunk, column);
+            destroy_objects(component_type, data + row * size, 1);
+            if(row != last)
+            {
+                relocate_objects(component_type, data + row * size, data + last * size, 1);
+            }
+
+            if(is_enableable_component(component_type))
+            {
+                // the enable bit moves with the row
+                set_component_enabled(chunk, row, column, is_component_enabled(chunk, last, column));
+                set_component_enabled(chunk, last, column, false);
+            }
+        }
+
+        // shared components are trivially copyable, an empty chunk has nothing left to destroy
+        if(--chunk->element_count == 0)
+        {
+            // the memory may come back as another chunk before the next flush
+            std::erase_if(changed_columns_, [chunk](auto const& changed) { return changed.first == chunk; });
+            chunk_nodes_.release_chunk(chunk);
+        }
+        return row != last ? last : invalid_index_value();
+    }
+
+    void archetype_instance::instantiate(prefab_t const& prefab, entity_t const* entities, uint32_t count, row_location_t* locations)
+    {
+        assert(archetype_ && prefab.get_archetype().get() == archetype_.get());
+        auto const& component_types = archetype_->component_types;
+
+        vector<void const*> shared_values;
+        for(uint32_t column = 0; column < component_types.size(); ++column)
+        {
+            if(is_shared_component(component_types[column]))
+            {
+                shared_values.push_back(prefab.get_value(column));
+            }
+        }
+
+        for(uint32_t spawned = 0; spawned < count;)
+        {
+            auto* chunk = acquire_chunk(shared_values.data());
+            auto const first = chunk->element_count;
+            auto const batch = (std::min)(archetype_->capacity_in_chunk - first, count - spawned);
+
+            std::copy_n(entities + spawned, batch, get_entities(chunk) + first);
+            for(uint32_t column = 0; column < component_types.size(); ++column)
+            {
+                auto const* component_type = component_types[column];
+                if(is_shared_component(component_type))
+                {
+                    continue;
+                }
+
+                fill_objects(component_type, get_column(chunk, column) + first * get_type_size(component_type), prefab.get_value(column), batch);
+                if(is_enableable_component(component_type))
+                {
+                    // the rows are counted after the batch is filled, so the bits are set in the mask directly
+                    auto* enable_mask = get_enable_mask(chunk, column);
+                    for(uint32_t row = first; row < first + batch; ++row)
+                    {
+                        enable_mask[row / 64] |= uint64_t{ 1 } << (row % 64);
+                    }
+                }
+            }
+
+            // entity fields of the copies still point at nothing, each row gets its own entity
+            for(auto const& reference : prefab.get_entity_references())
+            {
+                auto const size = get_type_size(component_types[reference.column]);
+                auto* field = get_column(chunk, reference.column) + first * size + reference.offset_in_component;
+                for(uint32_t index = 0; index < batch; ++index)
+                {
+                    std::memcpy(field + index * size, entities + spawned + index, sizeof(entity_t));
+                }
+            }
+
+            chunk->element_count += batch;
+            stamp_change_versions(chunk, change_version_);
+            publish_row_events(component_event_t::added, entities + spawned, batch);
+            if(locations)
+            {
+                for(uint32_t index = 0; index < batch; ++index)
+                {
+                    locations[spawned + index] = { chunk, first + index };
+                }
+            }
+            spawned += batch;
+        }
+    }
+
+    void archetype_instance::collect_reorder_slots()
+    {
+        cancel_reorder();
+
+        // chunks grouped by shared values, in list order within a group
+        vector<vector<chunk_t*>> partitions;
+        chunk_nodes_.for_each_chunk(
+            [this, &partitions](chunk_t* chunk)
+            {
+                auto const partition = std::ranges::find_if(partitions,
+                    [this, chunk](vector<chunk_t*> const& chunks)
+                    {
+                        return has_same_shared_values(chunk, chunks.front());
+                    });
+                if(partition != partitions.end())
+                {
+                    partition->push_back(chunk);
+                }
+                else
+                {
+                    partitions.emplace_back().push_back(chunk);
+                }
+            });
+
+        for(auto const& chunks : partitions)
+        {
+            for(auto* chunk : chunks)
+            {
+                for(uint32_t row = 0; row < chunk->element_count; ++row)
+                {
+                    reorder_.slots.push_back({ chunk, row });
+                }
+            }
+            reorder_.partition_ends.push_back(static_cast<uint32_t>(reorder_.slots.size()));
+        }
+    }
+
+    void archetype_instance::plan_reorder(vector<uint64_t> const& keys)
+    {
+        auto const count = static_cast<uint32_t>(reorder_.slots.size());
+        assert(keys.size() == count);
+        reorder_.order.resize(count);
+        reorder_.slot_of_row.resize(count);
+        reorder_.row_at_slot.resize(count);
+        std::iota(reorder_.order.begin(), reorder_.order.end(), 0u);
+        std::iota(reorder_.slot_of_row.begin(), reorder_.slot_of_row.end(), 0u);
+        std::iota(reorder_.row_at_slot.begin(), reorder_.row_at_slot.end(), 0u);
+
+        // stable, rows with equal keys keep their relative order & do not move for nothing
+        uint32_t begin = 0;
+        for(auto const end : reorder_.partition_ends)
+        {
+            std::stable_sort(reorder_.order.begin() + begin, reorder_.order.begin() + end,
+                [&keys](uint32_t lhs, uint32_t rhs) { return keys[lhs] < keys[rhs]; });
+            begin = end;
+        }
+    }
+
+    void archetype_instance::swap_rows(row_location_t lhs, row_location_t rhs)
+    {
+        std::swap(get_entities(lhs.chunk)[lhs.row], get_entities(rhs.chunk)[rhs.row]);
+
+        auto const& component_types = archetype_->component_types;
+        for(uint32_t column = 0; column < component_types.size(); ++column)
+        {
+            auto const* component_type = component_types[column];
+            if(is_enableable_component(component_type))
+            {
+                // the enable bit follows the row, an empty enableable component has nothing else to move
+                auto const lhs_enabled = is_component_enabled(lhs.chunk, lhs.row, column);
+                set_component_enabled(lhs.chunk, lhs.row, column, is_component_enabled(rhs.chunk, rhs.row, column));
+                set_component_enabled(rhs.chunk, rhs.row, column, lhs_enabled);
+            }
+            if(is_shared_component(component_type) || is_tag_component(component_type))
+            {
+                continue;
+            }
+
+            // one object of scratch, aligned for any component
+            auto const size = get_type_size(component_type);
+            std::array<std::max_align_t, 16> small_buffer;
+            std::unique_ptr<std::max_align_t[]> large_buffer;
+            auto* scratch = small_buffer.data();
+            if(size > sizeof(small_buffer))
+            {
+                large_buffer = std::make_unique<std::max_align_t[]>((size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+                scratch = large_buffer.get();
+            }
+
+            auto* lhs_value = get_column(lhs.chunk, column) + lhs.row * size;
+            auto* rhs_value = get_column(rhs.chunk, column) + rhs.row * size;
+            relocate_objects(component_type, scratch, lhs_value, 1);
+            relocate_objects(component_type, lhs_value, rhs_value, 1);
+            relocate_objects(component_type, rhs_value, scratch, 1);
+        }
+
+        // the content of both chunks changed
+        stamp_change_versions(lhs.chunk, change_version_);
+        stamp_change_versions(rhs.chunk, change_version_);
+    }
+
+    void archetype_instance::flush_changed_events()
+    {
+        if(changed_columns_.empty())
+        {
+            return;
+        }
+
+        // a chunk written by several systems is published once per column
+        std::ranges::sort(changed_columns_);
+        auto const duplicates = std::ranges::unique(changed_columns_);
+        changed_columns_.erase(duplicates.begin(), duplicates.end());
+        if(event_queues_)
+        {
+            for(auto const& [chunk, column] : changed_columns_)
+            {
+                event_queues_->publish(archetype_->component_types[column], component_event_t::changed, get_entities(chunk), chunk->element_count);
+            }
+        }
+        changed_columns_.clear();
+    }
+
+    void archetype_instance::stamp_change_versions(chunk_t* chunk, uint32_t version) noexcept
+    {
+        for(auto const& component_info : archetype_->component_infos)
+        {
+            if(component_info.change_version_offset != invalid_offset_value())
+            {
+                std::memcpy(reinterpret_cast<std::byte*>(chunk) + component_info.change_version_offset, &version, sizeof(version));
+            }
+        }
+    }
+
+    void archetype_instance::publish_row_events(component_event_t event, entity_t const* entities, uint32_t count)
+    {
+        if(!event_queues_ || !event_queues_->has_subscribers())
+        {
+            return;
+        }
+
+        for(auto const* component_type : archetype_->component_types)
+        {
+            event_queues_->publish(component_type, event, entities, count);
+        }
+    }
+
+    chunk_t* archetype_instance::acquire_chunk(void const* const* shared_values)
+    {
+        return chunk_nodes_.acquire_chunk(archetype_->capacity_in_chunk,
+            [this, shared_values](chunk_t const* chunk)
+            {
+                return has_shared_values(chunk, shared_values);
+            },
+            [this, shared_values](chunk_t* chunk)
+            {
+                // a new partition, the shared values are written once for all its rows
+                auto const& component_types = archetype_->component_types;
+                size_t shared_index = 0;
+                for(uint32_t column = 0; column < component_types.size(); ++column)
+                {
+                    if(is_shared_component(component_types[column]))
+                    {
+                        assert(shared_values && shared_values[shared_index]);
+                        copy_objects(component_types[column], get_column(chunk, column), shared_values[shared_index++], 1);
+                    }
+                    else if(is_enableable_component(component_types[column]))
+                    {
+                        std::fill_n(get_enable_mask(chunk, column), chunk_enable_mask_words(archetype_->capacity_in_chunk), uint64_t{ 0 });
+                    }
+                }
+            });
+    }
+
+    bool archetype_instance::has_shared_values(chunk_t const* chunk, void const* const* shared_values) const noexcept
+    {
+        size_t shared_index = 0;
+        auto const& component_types = archetype_->component_types;
+        for(uint32_t column = 0; column < component_types.size(); ++column)
+        {
+            if(is_shared_component(component_types[column]))
+            {
+                assert(shared_values && shared_values[shared_index]);
+                if(std::memcmp(get_chunk_shared_value(archetype_.get(), chunk, column), shared_values[shared_index++], get_type_size(component_types[column])) != 0)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool archetype_instance::has_same_shared_values(chunk_t const* lhs, chunk_t const* rhs) const noexcept
+    {
+        auto const& component_types = archetype_->component_types;
+        for(uint32_t column = 0; column < component_types.size(); ++column)
+        {
+            if(is_shared_component(component_types[column])
+                && std::memcmp(get_chunk_shared_value(archetype_.get(), lhs, column), get_chunk_shared_value(archetype_.get(), rhs, column), get_type_size(component_types[column])) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
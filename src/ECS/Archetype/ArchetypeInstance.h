@@ -1,11 +1,33 @@
 #pragma once
 #include "ECS/CoreTypes.h"
 #include "ECS/Chunk/ChunkNode.h"
+#include "ECS/Archetype/Prefab.h"
 
 namespace punk
 {
+    // a row in one of the chunks of an archetype instance
+    struct row_location_t
+    {
+        chunk_t*    chunk;
+        uint32_t    row;
+    };
+
     class archetype_instance
     {
+    private:
+        // rows are identified by their slot when the plan was made, slots are positions in target order space
+        struct reorder_plan_t
+        {
+            vector<row_location_t>      slots;
+            // slots of one shared value partition are contiguous, rows never leave their partition
+            vector<uint32_t>            partition_ends;
+            // order[slot] = row that ends up at slot
+            vector<uint32_t>            order;
+            vector<uint32_t>            slot_of_row;
+            vector<uint32_t>            row_at_slot;
+            uint32_t                    cursor = 0;
+        };
+
     public:
         static constexpr uint32_t non_archetype_index() { return (std::numeric_limits<uint32_t>::max)(); }
 
@@ -13,6 +35,11 @@ namespace punk
         uint32_t                    index_;
         archetype_ptr               archetype_;
         chunk_root_node             chunk_nodes_;
+        component_event_queues_t*   event_queues_ = nullptr;
+        uint32_t                    change_version_ = 0;
+        reorder_plan_t              reorder_;
+        // (chunk, column) written since the last flush_changed_events, only kept while someone subscribes
+        vector<std::pair<chunk_t*, uint32_t>> changed_columns_;
 
     public:
         explicit archetype_instance(archetype_ptr archetype)
@@ -22,7 +49,7 @@ namespace punk
         {
         }
 
-        ~archetype_instance() = default;
+        ~archetype_instance();
         archetype_instance(archetype_instance const&) = default;
         archetype_instance& operator=(archetype_instance const&) = default;
         archetype_instance(archetype_instance&&) = default;
@@ -32,8 +59,190 @@ namespace punk
         uint32_t get_index() const noexcept { return index_; }
         archetype_instance_handle_t get_handle() const noexcept { return archetype_instance_handle_t{ get_index() }; }
         void set_index(uint32_t index) noexcept { index_ = index; }
-        uint32_t get_hash() const noexcept { return archetype_ ? archetype_->hash : 0; }
+        uint64_t get_hash() const noexcept { return archetype_ ? archetype_->hash : 0; }
         bool is_non_archetype() const noexcept { return get_index() == 0; }
         archetype_ptr const& get_archetype() const { return archetype_; }
+        archetype_handle_t get_archetype_handle() const noexcept { return archetype_; }
+
+        template <typename Func>
+        void for_each_chunk(Func&& func) const { chunk_nodes_.for_each_chunk(std::forward<Func>(func)); }
+        size_t get_chunk_count() const noexcept { return chunk_nodes_.get_chunk_count(); }
+
+    public: // events
+        // added & removed events are published by row changes, changed events by flush_changed_events
+        void set_event_queues(component_event_queues_t* event_queues) noexcept { event_queues_ = event_queues; }
+
+        // records a write to a column of chunk, free when nobody subscribes to changes of its component
+        void mark_changed(chunk_t* chunk, uint32_t column)
+        {
+            if(event_queues_ && event_queues_->has_subscribers()
+                && event_queues_->is_subscribed(archetype_->component_types[column], component_event_t::changed))
+            {
+                changed_columns_.emplace_back(chunk, column);
+            }
+        }
+
+        // publishes every entity of the chunks written since the last flush
+        void flush_changed_events();
+
+        // view.for_each over every chunk, the writable columns of the view are marked changed in the chunks it visited
+        template <typename View, typename Func>
+        void for_each(View& view, Func&& func)
+        {
+            if(!view.matches(archetype_))
+            {
+                return;
+            }
+
+            // columns whose changes someone listens to, resolved once for the whole pass
+            std::array<uint32_t, View::component_count> tracked_columns;
+            size_t tracked_count = 0;
+            if(event_queues_ && event_queues_->has_subscribers())
+            {
+                for(auto const& access : view.get_access())
+                {
+                    auto const column = find_archetype_component(archetype_.get(), access.type);
+                    if(!access.read_only && column != invalid_index_value()
+                        && event_queues_->is_subscribed(access.type, component_event_t::changed))
+                    {
+                        tracked_columns[tracked_count++] = column;
+                    }
+                }
+            }
+
+            chunk_nodes_.for_each_chunk(
+                [&](chunk_t* chunk)
+                {
+                    view.for_each(archetype_, chunk, func);
+                    if(view.visited_last_chunk())
+                    {
+                        for(size_t index = 0; index < tracked_count; ++index)
+                        {
+                            changed_columns_.emplace_back(chunk, tracked_columns[index]);
+                        }
+                    }
+                });
+        }
+
+    public: // change versions
+        // version stamped on every column of the rows created from now on, views stamp their own writes
+        void set_change_version(uint32_t version) noexcept { change_version_ = version; }
+
+        uint32_t get_change_version(chunk_t const* chunk, uint32_t column) const noexcept
+        {
+            auto const offset = archetype_->component_infos[column].change_version_offset;
+            assert(offset != invalid_offset_value());
+            return *reinterpret_cast<uint32_t const*>(reinterpret_cast<std::byte const*>(chunk) + offset);
+        }
+
+    public: // rows
+        // constructs a row for entity, shared_values holds one value per shared column in column order
+        // the row lands in a chunk whose shared values are bytewise equal, a new chunk is started otherwise
+        row_location_t allocate_row(entity_t entity, void const* const* shared_values = nullptr);
+
+        // destroys a row & fills the hole with the last row of the chunk
+        // returns the row that moved into the hole, invalid_index_value() when nothing moved
+        // the entity now at row tells the owner whose location changed
+        uint32_t free_row(chunk_t* chunk, uint32_t row);
+
+        // spawns a row per entity as a copy of the prefab row, shared values come from the prefab image
+        // a chunk is filled a column at a time, so a spawn wave costs a few copies per column instead of per component
+        // locations receives the row of every entity when given
+        void instantiate(prefab_t const& prefab, entity_t const* entities, uint32_t count, row_location_t* locations = nullptr);
+
+        // entity of every row in chunk
+        entity_t* get_entities(chunk_t* chunk) const noexcept
+        {
+            return reinterpret_cast<entity_t*>(reinterpret_cast<std::byte*>(chunk) + archetype_->entities_offset);
+        }
+
+        // start of the column in chunk, row * size for the element of a row
+        std::byte* get_column(chunk_t* chunk, uint32_t column) const noexcept
+        {
+            return reinterpret_cast<std::byte*>(chunk) + archetype_->component_infos[column].offset_in_chunk;
+        }
+
+        // a bit per row, the column must hold an enableable component
+        uint64_t* get_enable_mask(chunk_t* chunk, uint32_t column) const noexcept
+        {
+            assert(archetype_->component_infos[column].enable_mask_offset != invalid_offset_value());
+            return reinterpret_cast<uint64_t*>(reinterpret_cast<std::byte*>(chunk) + archetype_->component_infos[column].enable_mask_offset);
+        }
+
+        // toggling is a bit write, the row stays where it is
+        void set_component_enabled(chunk_t* chunk, uint32_t row, uint32_t column, bool enabled) noexcept
+        {
+            assert(row < chunk->element_count);
+            auto& word = get_enable_mask(chunk, column)[row / 64];
+            auto const bit = uint64_t{ 1 } << (row % 64);
+            word = enabled ? (word | bit) : (word & ~bit);
+        }
+
+        bool is_component_enabled(chunk_t* chunk, uint32_t row, uint32_t column) const noexcept
+        {
+            assert(row < chunk->element_count);
+            return (get_enable_mask(chunk, column)[row / 64] >> (row % 64)) & 1;
+        }
+
+    public: // row order
+        // plans to sort the rows by key(chunk_t*, uint32_t row) -> uint64_t, e.g. a morton code of their position
+        // the plan costs one sort, reorder_step applies it a bounded number of swaps at a time
+        // rows only move between chunks with the same shared values, freeing a row drops the plan
+        template <typename Key>
+        void begin_reorder(Key&& key)
+        {
+            collect_reorder_slots();
+            vector<uint64_t> keys;
+            keys.reserve(reorder_.slots.size());
+            for(auto const& slot : reorder_.slots)
+            {
+                keys.push_back(key(slot.chunk, slot.row));
+            }
+            plan_reorder(keys);
+        }
+
+        // swaps at most max_swaps pairs of rows, on_moved(entity_t, row_location_t) for every row that changed place
+        // returns true once the plan is done
+        template <typename OnMoved>
+        bool reorder_step(uint32_t max_swaps, OnMoved&& on_moved)
+        {
+            for(; max_swaps > 0 && is_reordering(); ++reorder_.cursor)
+            {
+                auto const target = reorder_.cursor;
+                auto const source = reorder_.slot_of_row[reorder_.order[target]];
+                if(source == target)
+                {
+                    continue;
+                }
+
+                auto const target_location = reorder_.slots[target];
+                auto const source_location = reorder_.slots[source];
+                swap_rows(target_location, source_location);
+
+                auto const displaced = reorder_.row_at_slot[target];
+                reorder_.row_at_slot[source] = displaced;
+                reorder_.slot_of_row[displaced] = source;
+                reorder_.row_at_slot[target] = reorder_.order[target];
+                reorder_.slot_of_row[reorder_.order[target]] = target;
+
+                on_moved(get_entities(target_location.chunk)[target_location.row], target_location);
+                on_moved(get_entities(source_location.chunk)[source_location.row], source_location);
+                --max_swaps;
+            }
+            return !is_reordering();
+        }
+
+        bool is_reordering() const noexcept { return reorder_.cursor < reorder_.slots.size(); }
+        void cancel_reorder() noexcept { reorder_ = {}; }
+
+    private:
+        void collect_reorder_slots();
+        void plan_reorder(vector<uint64_t> const& keys);
+        void swap_rows(row_location_t lhs, row_location_t rhs);
+        chunk_t* acquire_chunk(void const* const* shared_values);
+        void stamp_change_versions(chunk_t* chunk, uint32_t version) noexcept;
+        void publish_row_events(component_event_t event, entity_t const* entities, uint32_t count);
+        bool has_shared_values(chunk_t const* chunk, void const* const* shared_values) const noexcept;
+        bool has_same_shared_values(chunk_t const* lhs, chunk_t const* rhs) const noexcept;
     };
 }
\ No newline at end of file
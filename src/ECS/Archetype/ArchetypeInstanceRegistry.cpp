@@ -31,7 +31,7 @@ namespace punk
         detach_archetype_by_hash(archetype->hash);
     }
 
-    void archetype_instance_registry::detach_archetype_by_hash(uint32_t hash)
+    void archetype_instance_registry::detach_archetype_by_hash(uint64_t hash)
     {
         auto itr = archetype_hash_to_instance_.find(hash);
         if (itr != archetype_hash_to_instance_.end())
@@ -82,7 +82,7 @@ namespace punk
         return const_cast<archetype_instance*>(const_cast<archetype_instance_registry const*>(this)->get_archetype_instance(index));
     }
 
-    archetype_instance const* archetype_instance_registry::get_archetype_instance(uint32_t hash) const
+    archetype_instance const* archetype_instance_registry::get_archetype_instance(uint64_t hash) const
     {
         auto itr = archetype_hash_to_instance_.find(hash);
         if (itr != archetype_hash_to_instance_.end())
@@ -92,7 +92,7 @@ namespace punk
         return nullptr;
     }
 
-    archetype_instance* archetype_instance_registry::get_archetype_instance(uint32_t hash)
+    archetype_instance* archetype_instance_registry::get_archetype_instance(uint64_t hash)
     {
         return const_cast<archetype_instance*>(const_cast<archetype_instance_registry const*>(this)->get_archetype_instance(hash));
     }
@@ -0,0 +1,200 @@
+#include "ECS/CoreTypes.h"
+
+namespace punk
+{
+    namespace
+    {
+        std::string_view trim(std::string_view text) noexcept
+        {
+            auto const first = text.find_first_not_of(" \t\r");
+            if(first == std::string_view::npos)
+            {
+                return {};
+            }
+            auto const last = text.find_last_not_of(" \t\r");
+            return text.substr(first, last - first + 1);
+        }
+
+        // the keyword is followed by whitespace or the end of the line
+        bool consume_keyword(std::string_view& line, std::string_view keyword) noexcept
+        {
+            if(!line.starts_with(keyword))
+            {
+                return false;
+            }
+            auto const rest = line.substr(keyword.size());
+            if(!rest.empty() && rest.front() != ' ' && rest.front() != '\t')
+            {
+                return false;
+            }
+            line = trim(rest);
+            return true;
+        }
+
+        // resolves every name, false when any of them is not registered
+        bool resolve_component_types(runtime_type_registry_t* runtime_type_registry, vector<string> const& names, vector<type_info_t const*>& component_types)
+        {
+            component_types.clear();
+            for(auto const& name : names)
+            {
+                auto const* component_type = runtime_type_registry->get_type_info(name.c_str());
+                if(!component_type)
+                {
+                    return false;
+                }
+                component_types.push_back(component_type);
+            }
+            return true;
+        }
+    }
+
+    error_code parse_archetype_manifest(std::string_view text, archetype_manifest_t& manifest, size_t* error_line)
+    {
+        size_t line_number = 0;
+        auto const fail = [&]()
+            {
+                if(error_line)
+                {
+                    *error_line = line_number;
+                }
+                return error_code::manifest_syntax_error;
+            };
+
+        while(!text.empty())
+        {
+            ++line_number;
+            auto const line_end = text.find('\n');
+            auto line = trim(text.substr(0, line_end));
+            text = line_end == std::string_view::npos ? std::string_view{} : text.substr(line_end + 1);
+
+            if(line.empty() || line.front() == '#')
+            {
+                continue;
+            }
+
+            if(consume_keyword(line, "archetype"))
+            {
+                auto& entry = manifest.archetypes.emplace_back();
+                // type names may hold commas & spaces (templates), ';' is the only separator
+                while(!line.empty())
+                {
+                    auto const separator = line.find(';');
+                    auto const name = trim(line.substr(0, separator));
+                    if(!name.empty())
+                    {
+                        entry.component_type_names.emplace_back(name);
+                    }
+                    line = separator == std::string_view::npos ? std::string_view{} : line.substr(separator + 1);
+                }
+
+                if(entry.component_type_names.empty())
+                {
+                    return fail();
+                }
+            }
+            else if(line.front() == '+' || line.front() == '-')
+            {
+                auto const name = trim(line.substr(1));
+                if(manifest.archetypes.empty() || name.empty())
+                {
+                    return fail();
+                }
+                manifest.archetypes.back().transitions.push_back({ line.front() == '+', string{ name } });
+            }
+            else
+            {
+                return fail();
+            }
+        }
+        return error_code::succeed;
+    }
+
+    string write_archetype_manifest(archetype_manifest_t const& manifest)
+    {
+        string text;
+        for(auto const& entry : manifest.archetypes)
+        {
+            text += "archetype";
+            for(size_t index = 0; index < entry.component_type_names.size(); ++index)
+            {
+                text += index == 0 ? " " : "; ";
+                text += entry.component_type_names[index];
+            }
+            text += '\n';
+
+            for(auto const& transition : entry.transitions)
+            {
+                text += transition.include ? "+ " : "- ";
+                text += transition.component_type_name;
+                text += '\n';
+            }
+        }
+        return text;
+    }
+
+    archetype_manifest_t capture_archetype_manifest(archetype_registry_t* archetype_registry)
+    {
+        assert(archetype_registry);
+
+        archetype_manifest_t manifest;
+        archetype_registry->for_each_archetype(
+            [&manifest](archetype_ptr const& archetype)
+            {
+                auto& entry = manifest.archetypes.emplace_back();
+                for(auto const* component_type : archetype->component_types)
+                {
+                    entry.component_type_names.emplace_back(get_type_name(component_type));
+                }
+            });
+
+        // stable output for diffing, the registry enumerates in hash order
+        std::ranges::sort(manifest.archetypes, std::less<>{}, &archetype_manifest_t::archetype_entry_t::component_type_names);
+        return manifest;
+    }
+
+    error_code preload_archetypes(archetype_registry_t* archetype_registry, runtime_type_registry_t* runtime_type_registry,
+        archetype_manifest_t const& manifest, vector<archetype_ptr>& preloaded)
+    {
+        assert(archetype_registry && runtime_type_registry);
+
+        auto result = error_code::succeed;
+        vector<type_info_t const*> component_types;
+        for(auto const& entry : manifest.archetypes)
+        {
+            if(!resolve_component_types(runtime_type_registry, entry.component_type_names, component_types))
+            {
+                result = error_code::unknown_component_type;
+                continue;
+            }
+
+            // sorting, hashing, chunk layout & registry insertion are paid here instead of in the first frames
+            auto archetype = archetype_registry->get_or_create_archetype(component_types.data(), component_types.size());
+            if(!archetype)
+            {
+                result = error_code::invalid_archetype;
+                continue;
+            }
+
+            for(auto const& transition : entry.transitions)
+            {
+                auto const* component_type = runtime_type_registry->get_type_info(transition.component_type_name.c_str());
+                if(!component_type)
+                {
+                    result = error_code::unknown_component_type;
+                    continue;
+                }
+
+                // the transition later resolves to the same registered archetype with a lock-free lookup
+                auto target = transition.include
+                    ? archetype_registry->archetype_include_components(archetype, 1, &component_type)
+                    : archetype_registry->archetype_exclude_components(archetype, &component_type, 1);
+                if(target && target != archetype)
+                {
+                    preloaded.push_back(std::move(target));
+                }
+            }
+            preloaded.push_back(std::move(archetype));
+        }
+        return result;
+    }
+}
@@ -31,19 +31,11 @@ namespace punk
             return nullptr;
         }
 
-        // stable sort components by type hash value
-        std::ranges::stable_sort(all_comps,
-            [](auto const* lhs, auto const* rhs)
-            {
-                return get_type_name_hash(lhs) < get_type_name_hash(rhs);
-            });
+        // sort components into signature order
+        std::ranges::stable_sort(all_comps, type_info_less);
 
         // remove unique components
-        auto [end, _] = std::ranges::unique(all_comps,
-            [](auto const* lhs, auto const* rhs)
-            {
-                return get_type_name_hash(lhs) == get_type_name_hash(rhs);
-            });
+        auto [end, _] = std::ranges::unique(all_comps);
 
         // adapt the component count
         component_count = std::ranges::distance(all_comps.begin(), end);
@@ -55,48 +47,44 @@ namespace punk
     archetype_ptr archetype_registry_t::archetype_include_components(archetype_ptr const& archetype,
         size_t component_count, type_info_t const** component_types, uint32_t* include_orders)
     {
-        if(!component_types || component_count == 0)
+        if(!archetype || !component_types || component_count == 0)
         {
             return archetype;
         }
-        include_orders = include_orders ? include_orders : PUNK_ALLOCA(uint32_t, component_count);
-
-        std::ranges::subrange orders{ include_orders, include_orders + component_count };
-        // generate an index sequence for orders as the initial value
-        std::ranges::generate(orders, [index{ 0u }]() mutable { return index++; });
-        // sort the index, just like the indirect array of component_types
-        std::ranges::stable_sort(orders,
-            [component_types](auto const lhs, auto const rhs)
-            {
-                return get_type_name_hash(component_types[lhs]) < get_type_name_hash(component_types[rhs]);
-            });
+
+        // sort a copy, the caller's order is kept for include_orders
+        auto* sorted_begin = PUNK_ALLOCA(type_info_t const*, component_count);
+        std::ranges::subrange sorted_types{ sorted_begin, sorted_begin + component_count };
+        std::ranges::copy(component_types, component_types + component_count, sorted_begin);
+        std::ranges::stable_sort(sorted_types, type_info_less);
+
         // remove duplicate components
-        auto [invalid_begin, invalid_end] = std::ranges::unique(orders,
-            [component_types](auto const lhs, auto const rhs)
-            {
-                return get_type_name_hash(component_types[lhs]) == get_type_name_hash(component_types[rhs]);
-            });
-        // mark the removed duplicate components` order as invalid value
-        std::ranges::for_each(invalid_begin, invalid_end, [](auto& order) { order = invalid_index_value(); });
+        auto [unique_end, _] = std::ranges::unique(sorted_types);
 
-        component_count = std::ranges::distance(orders.begin(), invalid_begin);
-        return archetype_include_components_impl(archetype, component_count, component_types, include_orders);
+        auto result_archetype = archetype_include_components_impl(archetype, sorted_begin, std::ranges::distance(sorted_begin, unique_end));
+        if(include_orders)
+        {
+            std::ranges::transform(component_types, component_types + component_count, include_orders,
+                [&result_archetype](type_info_t const* component_type)
+                {
+                    return find_archetype_component(result_archetype.get(), component_type);
+                });
+        }
+        return result_archetype;
     }
 
     archetype_ptr archetype_registry_t::archetype_exclude_components(archetype_ptr const& archetype, type_info_t const** component_types, size_t component_count)
     {
-        if(!component_types || component_count == 0)
+        if(!archetype || !component_types || component_count == 0)
         {
             return archetype;
         }
 
-        std::ranges::stable_sort(component_types, component_types + component_count,
-            [](auto const* lhs, auto const* rhs)
-            {
-                return get_type_name_hash(lhs) < get_type_name_hash(rhs);
-            });
+        auto* sorted_begin = PUNK_ALLOCA(type_info_t const*, component_count);
+        std::ranges::copy(component_types, component_types + component_count, sorted_begin);
+        std::ranges::stable_sort(sorted_begin, sorted_begin + component_count, type_info_less);
 
-        return archetype_exclude_components(archetype, component_types, component_count);
+        return archetype_exclude_components_impl(archetype, sorted_begin, component_count);
     }
 }
 
@@ -106,121 +94,225 @@ namespace punk
     archetype_registry_impl::archetype_registry_impl(runtime_type_registry_t* runtime_type_registry_t)
         : archetype_registry_t(runtime_type_registry_t) {}
 
-    archetype_ptr archetype_registry_impl::get_archetype(uint32_t hash)
+    archetype_registry_impl::~archetype_registry_impl()
     {
-        scoped_spin_lock_t lock{ archetype_lock };
-        auto itr = all_archetypes.find(hash);
-        if (itr != all_archetypes.end())
+        for(auto& shard : archetype_shards)
         {
-            auto result = itr->second.lock();
-            return result;
+            std::unique_ptr<archetype_table_t> table{ shard.table.exchange(nullptr, std::memory_order_acquire) };
+            for(size_t index = 0; table && index <= table->mask; ++index)
+            {
+                auto* node = table->slots[index].node.load(std::memory_order_relaxed);
+                if(node != &tombstone_node)
+                {
+                    delete node;
+                }
+            }
         }
-        return nullptr;
     }
 
-    archetype_ptr archetype_registry_impl::get_or_create_archetype_impl(type_info_t const** sorted_component_types, size_t component_count)
+    archetype_ptr archetype_registry_impl::get_archetype(uint64_t hash)
     {
-        auto* hash_ptr = PUNK_ALLOCA(uint32_t, component_count);
-        std::ranges::subrange all_hash{ hash_ptr, hash_ptr + component_count };
-        std::ranges::subrange all_comps{ sorted_component_types, sorted_component_types + component_count };
-        std::ranges::transform(all_comps, all_hash.begin(),
-            [](auto const* type_info)
-            {
-                return get_type_name_hash(type_info);
-            });
-        auto const archetype_hash = hash_memory(reinterpret_cast<char const*>(all_hash.data()), sizeof(uint32_t) * all_hash.size());
+        auto guard = archetype_epoch_.pin();
+        auto const* slot = find_slot_by_hash(get_shard(hash).table.load(std::memory_order_acquire), hash);
+        return slot ? slot->node.load(std::memory_order_acquire)->weak.lock() : nullptr;
+    }
 
-        auto archetype = get_archetype(archetype_hash);
-        if(archetype)
+    archetype_handle_t archetype_registry_impl::find_archetype_handle(uint64_t hash)
+    {
+        // expired() only reads the count, the archetype memory itself is kept by the epoch domain
+        auto guard = archetype_epoch_.pin();
+        auto const* slot = find_slot_by_hash(get_shard(hash).table.load(std::memory_order_acquire), hash);
+        auto const* node = slot ? slot->node.load(std::memory_order_acquire) : nullptr;
+        if (node && node != &tombstone_node && !node->weak.expired())
         {
-            return archetype;
+            return archetype_handle_t{ node->archetype };
         }
+        return archetype_handle_t{};
+    }
 
-        archetype = allocate_archetype(archetype_hash, component_count);
-        initialize_archetype(archetype.get(), sorted_component_types, component_count);
-        archetype = register_archetype(archetype);
-        return archetype;
+    void archetype_registry_impl::for_each_archetype(std::function<void(archetype_ptr const&)> const& func)
+    {
+        auto guard = archetype_epoch_.pin();
+        for(auto const& shard : archetype_shards)
+        {
+            auto const* table = shard.table.load(std::memory_order_acquire);
+            for(size_t index = 0; table && index <= table->mask; ++index)
+            {
+                auto const* node = table->slots[index].node.load(std::memory_order_acquire);
+                auto archetype = node ? node->weak.lock() : nullptr;
+                if(archetype)
+                {
+                    func(archetype);
+                }
+            }
+        }
     }
 
-    archetype_ptr archetype_registry_impl::archetype_include_components_impl(archetype_ptr const& archetype, 
-        size_t component_count, type_info_t const** component_types, uint32_t* include_orders)
+    archetype_registry_stats_t archetype_registry_impl::get_stats() const
     {
-        auto const current_archetype_component_count = archetype->component_infos.size();
-        auto const new_archetype_components_count = current_archetype_component_count + component_count;
-        auto* component_infos_ptr = PUNK_ALLOCA(type_info_t const*, new_archetype_components_count);
-        std::ranges::subrange merge_comp_type_infos
+        archetype_registry_stats_t stats{};
+        for(auto const& shard : archetype_shards)
         {
-            component_infos_ptr,
-            component_infos_ptr + new_archetype_components_count
-        };
+            stats.archetype_count += shard.archetype_count.load(std::memory_order_relaxed);
+            stats.lock_acquisitions += shard.lock_acquisitions.load(std::memory_order_relaxed);
+            stats.lock_contentions += shard.lock_contentions.load(std::memory_order_relaxed);
+            stats.table_rebuilds += shard.table_rebuilds.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
 
-        std::ranges::subrange orders{ include_orders, include_orders + component_count };
-        uint32_t i = 0, j = 0, index = 0;
-        while(i < current_archetype_component_count && j < component_count)
+    void archetype_registry_impl::reset_stats()
+    {
+        for(auto& shard : archetype_shards)
         {
-            auto const* current_component_type = archetype->component_types[i];
-            auto const current_index = orders[j];
-            auto const* current_append_type = component_types[current_index];
+            shard.lock_acquisitions.store(0, std::memory_order_relaxed);
+            shard.lock_contentions.store(0, std::memory_order_relaxed);
+            shard.table_rebuilds.store(0, std::memory_order_relaxed);
+        }
+    }
 
-            auto const current_hash = get_type_name_hash(current_component_type);
-            auto const append_hash = get_type_name_hash(current_append_type);
+    std::unique_lock<archetype_registry_impl::spin_lock_t> archetype_registry_impl::lock_shard(archetype_shard_t& shard)
+    {
+        if(!shard.lock.tryLock())
+        {
+            shard.lock_contentions.fetch_add(1, std::memory_order_relaxed);
+            shard.lock.lock();
+        }
+        shard.lock_acquisitions.fetch_add(1, std::memory_order_relaxed);
+        return std::unique_lock<spin_lock_t>{ shard.lock, std::adopt_lock };
+    }
 
-            if(current_hash < append_hash)
+    void archetype_registry_impl::insert_node(archetype_shard_t& shard, uint64_t hash, archetype_node_t* node)
+    {
+        // keep at least a quarter of the slots empty so every probe ends
+        auto* table = shard.table.load(std::memory_order_relaxed);
+        if(!table || (table->used + 1) * 4 > (table->mask + 1) * 3)
+        {
+            table = rebuild_table(shard, table);
+        }
+
+        for(auto index = (hash >> shard_bits) & table->mask; ; index = (index + 1) & table->mask)
+        {
+            auto& slot = table->slots[index];
+            if(!slot.node.load(std::memory_order_relaxed))
             {
-                merge_comp_type_infos[index++] = current_component_type;
-                ++i;
+                slot.hash.store(hash, std::memory_order_relaxed);
+                slot.node.store(node, std::memory_order_release);
+                ++table->used;
+                return;
             }
-            else if(current_hash > append_hash)
+        }
+    }
+
+    archetype_registry_impl::archetype_table_t* archetype_registry_impl::rebuild_table(archetype_shard_t& shard, archetype_table_t* table)
+    {
+        auto const live_count = shard.archetype_count.load(std::memory_order_relaxed);
+        auto const capacity = std::bit_ceil((std::max)(size_t{ 16 }, (live_count + 1) * 2));
+
+        auto new_table = std::make_unique<archetype_table_t>();
+        new_table->mask = capacity - 1;
+        new_table->used = 0;
+        new_table->slots = std::make_unique<archetype_slot_t[]>(capacity);
+        for(size_t index = 0; table && index <= table->mask; ++index)
+        {
+            auto const& slot = table->slots[index];
+            auto* node = slot.node.load(std::memory_order_relaxed);
+            if(!node || node == &tombstone_node)
             {
-                orders[current_index] = index++;
-                merge_comp_type_infos[index] = current_append_type;
-                ++j;
+                continue;
             }
-            else //(current_hash == append_hash)
+
+            auto const hash = slot.hash.load(std::memory_order_relaxed);
+            auto new_index = (hash >> shard_bits) & new_table->mask;
+            while(new_table->slots[new_index].node.load(std::memory_order_relaxed))
             {
-                orders[current_index] = invalid_index_value();
-                ++j;
+                new_index = (new_index + 1) & new_table->mask;
             }
+            new_table->slots[new_index].hash.store(hash, std::memory_order_relaxed);
+            new_table->slots[new_index].node.store(node, std::memory_order_relaxed);
+            ++new_table->used;
         }
 
-        while(i < current_archetype_component_count)
+        // readers still probing the old table keep it alive by their pin, the nodes moved over
+        shard.table.store(new_table.get(), std::memory_order_release);
+        shard.table_rebuilds.fetch_add(1, std::memory_order_relaxed);
+        if(table)
         {
-            auto const* current_component_type = archetype->component_types[j];
-            merge_comp_type_infos[index++] = current_component_type;
-            ++i;
+            archetype_epoch_.retire(table);
         }
-        while(j < component_count)
+        return new_table.release();
+    }
+
+    archetype_ptr archetype_registry_impl::find_archetype(archetype_signature_t signature, uint64_t hash)
+    {
+        auto guard = archetype_epoch_.pin();
+        auto const* table = get_shard(hash).table.load(std::memory_order_acquire);
+        auto const* slot = find_slot(table, hash,
+            [signature](archetype_t const* archetype)
+            {
+                return archetype_signature_equal{}(archetype, signature);
+            });
+        return slot ? slot->node.load(std::memory_order_acquire)->weak.lock() : nullptr;
+    }
+
+    archetype_ptr archetype_registry_impl::get_or_create_archetype_impl(type_info_t const** sorted_component_types, size_t component_count)
+    {
+        archetype_signature_t const signature{ sorted_component_types, component_count };
+        auto const archetype_hash = archetype_signature_hash{}(signature);
+
+        auto archetype = find_archetype(signature, archetype_hash);
+        if(archetype)
         {
-            auto const current_index = orders[j];
-            auto const* current_append_type = component_types[current_index];
-            orders[current_index] = index++;
-            merge_comp_type_infos[index] = current_append_type;
-            ++j;
+            return archetype;
         }
 
-        return get_or_create_archetype_impl(merge_comp_type_infos.data(), merge_comp_type_infos.size());
+        archetype = allocate_archetype(archetype_hash, component_count);
+        initialize_archetype(archetype.get(), sorted_component_types, component_count);
+        archetype = register_archetype(archetype);
+        return archetype;
     }
 
-    archetype_ptr archetype_registry_impl::archetype_exclude_components_impl(archetype_ptr const& archetype,type_info_t const** component_types, size_t component_count)
+    archetype_ptr archetype_registry_impl::archetype_include_components_impl(archetype_ptr const& archetype, type_info_t const** sorted_component_types, size_t component_count)
     {
-        auto const components_count = archetype->component_infos.size();
+        auto const merged_capacity = archetype->component_types.size() + component_count;
+        auto* merged_begin = PUNK_ALLOCA(type_info_t const*, merged_capacity);
+
+        // both sides are sorted by type_info_less & unique, components already in the archetype are kept once
+        auto [_, __, merged_end] = std::ranges::set_union(
+            archetype->component_types,
+            std::ranges::subrange{ sorted_component_types, sorted_component_types + component_count },
+            merged_begin,
+            type_info_less);
+
+        auto const merged_count = static_cast<size_t>(std::ranges::distance(merged_begin, merged_end));
+        if(merged_count == archetype->component_types.size())
+        {
+            return archetype;
+        }
+        return get_or_create_archetype_impl(merged_begin, merged_count);
+    }
+
+    archetype_ptr archetype_registry_impl::archetype_exclude_components_impl(archetype_ptr const& archetype, type_info_t const** sorted_component_types, size_t component_count)
+    {
+        auto const components_count = archetype->component_types.size();
         auto* diff_comp_begin = PUNK_ALLOCA(type_info_t const*, components_count);
-        std::ranges::subrange difference_type_infos{ diff_comp_begin, diff_comp_begin + components_count };
-        std::ranges::subrange subtract_type_infos{ component_types, component_types + component_count };
 
         auto [_, diff_comp_end] = std::ranges::set_difference(
             archetype->component_types,
-            subtract_type_infos,
-            difference_type_infos.begin(),
-            [](type_info_t const* lhs, type_info_t const* rhs)
-            {
-                return get_type_name_hash(lhs) < get_type_name_hash(rhs);
-            });
+            std::ranges::subrange{ sorted_component_types, sorted_component_types + component_count },
+            diff_comp_begin,
+            type_info_less);
 
-        return get_or_create_archetype_impl(diff_comp_begin, std::ranges::distance(diff_comp_end, diff_comp_begin));
+        auto const diff_count = static_cast<size_t>(std::ranges::distance(diff_comp_begin, diff_comp_end));
+        if(diff_count == components_count)
+        {
+            return archetype;
+        }
+        // removing every component leaves no archetype
+        return diff_count > 0 ? get_or_create_archetype_impl(diff_comp_begin, diff_count) : nullptr;
     }
 
-    archetype_ptr archetype_registry_impl::allocate_archetype(uint32_t hash, size_t component_count)
+    archetype_ptr archetype_registry_impl::allocate_archetype(uint64_t hash, size_t component_count)
     {
         archetype_ptr archetype = archetype_ptr
         {
@@ -244,33 +336,65 @@ namespace punk
                 archetype->registered = false;
             }
 
-            delete archetype;
+            // pinned readers may still hold a handle, free it once they have left
+            archetype_epoch_.retire(archetype);
         }
     }
 
     archetype_ptr archetype_registry_impl::register_archetype(archetype_ptr& archetype)
     {
         assert(archetype);
-        scoped_spin_lock_t lock{ archetype_lock };
-        auto [weak_archetype, result] = all_archetypes.emplace(archetype->hash, archetype);
-        if(result)
+        auto& shard = get_shard(archetype->hash);
+        auto lock = lock_shard(shard);
+
+        // another thread may have registered the same signature since our lock-free probe
+        auto* slot = find_slot(shard.table.load(std::memory_order_relaxed), archetype->hash,
+            [&archetype](archetype_t const* registered_archetype)
+            {
+                return archetype_signature_equal{}(registered_archetype, archetype.get());
+            });
+        auto* node = new archetype_node_t{ archetype.get(), archetype };
+        if(slot)
         {
-            archetype->registered = true;
-            return archetype;
+            auto* registered_node = slot->node.load(std::memory_order_relaxed);
+            auto result_archetype = registered_node->weak.lock();
+            if(result_archetype)
+            {
+                delete node;
+                return result_archetype;
+            }
+
+            // the registered one is expiring but not unregistered yet, take over its slot
+            slot->node.store(node, std::memory_order_release);
+            archetype_epoch_.retire(registered_node);
         }
-        auto result_archetype = weak_archetype->second.lock();
-        assert(result_archetype);
-        return result_archetype;
+        else
+        {
+            insert_node(shard, archetype->hash, node);
+            shard.archetype_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        archetype->registered = true;
+        return archetype;
     }
 
     void archetype_registry_impl::unregister_archetype(archetype_t* archetype)
     {
-        scoped_spin_lock_t lock{ archetype_lock };
-        auto itr = all_archetypes.find(archetype->hash);
-        if(itr != all_archetypes.end())
+        // match by identity, a slot taken over by a newer archetype with the same signature stays
+        auto& shard = get_shard(archetype->hash);
+        auto lock = lock_shard(shard);
+        auto* slot = find_slot(shard.table.load(std::memory_order_relaxed), archetype->hash,
+            [archetype](archetype_t const* registered_archetype)
+            {
+                return registered_archetype == archetype;
+            });
+        if(!slot)
         {
-            all_archetypes.erase(itr);
+            return;
         }
+
+        auto* registered_node = slot->node.exchange(&tombstone_node, std::memory_order_acq_rel);
+        shard.archetype_count.fetch_sub(1, std::memory_order_relaxed);
+        archetype_epoch_.retire(registered_node);
     }
 
     void archetype_registry_impl::initialize_archetype(archetype_t* archetype, type_info_t const** component_types, size_t count)
@@ -288,48 +412,41 @@ namespace punk
     {
         assert(archetype);
 
-        auto const all_comp_size = std::reduce(
-            archetype->component_types.begin(),
-            archetype->component_types.end(),
-            0u, [archetype](uint32_t acc, auto const* component_type)
-            {
-                assert(component_type);
-                return acc + component_type->size;
-            });
-
-        constexpr uint32_t data_block_size = chunk_t::chunke_size - sizeof(chunk_t);
-        uint32_t capacity = data_block_size / all_comp_size + 1;
-
-        uint32_t chunk_size;
-        std::vector<uint32_t> offsets(archetype->component_types.size(), 0u);
-        do
+        auto const count = archetype->component_types.size();
+        vector<uint32_t> sizes(count), alignments(count), offsets(count);
+        auto shared = std::make_unique<bool[]>(count);
+        uint32_t enable_mask_count = 0;
+        for(size_t index = 0; index < count; ++index)
         {
-            capacity--;
-            chunk_size = calculate_chunk_size_and_offsets(archetype, capacity, offsets);
-        } while (data_block_size < chunk_size);
-
-        std::ranges::transform(offsets, std::back_inserter(archetype->component_infos),
-            [](uint32_t offset)
-            {
-                return component_info_t{ .offset_in_chunk = offset };
-            });
-        archetype->capacity_in_chunk = capacity;
-    }
+            auto const* component_type = archetype->component_types[index];
+            assert(component_type);
+            sizes[index] = is_tag_component(component_type) ? 0 : component_type->size;
+            alignments[index] = component_type->alignment;
+            shared[index] = is_shared_component(component_type);
+            enable_mask_count += is_enableable_component(component_type) ? 1 : 0;
+        }
 
-    uint32_t archetype_registry_impl::calculate_chunk_size_and_offsets(archetype_t* archetype, uint32_t capacity, std::vector<uint32_t>& offsets)
-    {
-        assert(archetype);
-        uint32_t size = sizeof(chunk_t);
+        uint32_t enable_masks_offset = 0;
+        auto const capacity = compute_chunk_layout(sizes.data(), alignments.data(), count, offsets.data(),
+            shared.get(), enable_mask_count, &enable_masks_offset, &archetype->entities_offset);
+        assert(capacity > 0 && "components do not fit in one chunk");
 
-        offsets.clear();
-        std::ranges::transform(archetype->component_types, std::back_inserter(offsets),
-            [&size, capacity](auto const* component_type)
+        // change versions & enable masks follow each other in column order
+        auto const enable_mask_size = chunk_enable_mask_words(capacity) * static_cast<uint32_t>(sizeof(uint64_t));
+        auto change_version_offset = chunk_header_size_in_bytes;
+        for(size_t index = 0; index < count; ++index)
+        {
+            auto const enableable = is_enableable_component(archetype->component_types[index]);
+            auto const has_storage = sizes[index] != 0;
+            archetype->component_infos.push_back(component_info_t
             {
-                auto const offset = align_up(size, component_type->alignment);
-                size += component_type->size * capacity;
-                return offset;
+                .offset_in_chunk = offsets[index],
+                .enable_mask_offset = enableable ? enable_masks_offset : invalid_offset_value(),
+                .change_version_offset = has_storage ? change_version_offset : invalid_offset_value()
             });
-
-        return size;
+            enable_masks_offset += enableable ? enable_mask_size : 0;
+            change_version_offset += has_storage ? chunk_change_version_size_in_bytes : 0;
+        }
+        archetype->capacity_in_chunk = static_cast<uint16_t>(capacity);
     }
 }
\ No newline at end of file
@@ -4,6 +4,12 @@
 #include "Base/Utils/Hash.h"
 #include "Base/Async/Async.h"
 #include "Base/Async/AsyncStaticFor.h"
+#include <span>
+#include <mutex>
+
+#ifndef PUNK_ARCHETYPE_REGISTRY_SHARD_COUNT
+#define PUNK_ARCHETYPE_REGISTRY_SHARD_COUNT 16
+#endif
 
 #ifndef PUNK_ALLOCA
 #define PUNK_ALLOCA(type, count) static_cast<std::add_pointer_t<type>>(alloca(sizeof(type) * (count)))
@@ -11,35 +17,156 @@
 
 namespace punk
 {
+    using archetype_signature_t = std::span<type_info_t const* const>;
+
+    // archetypes are keyed by their full sorted component signature, the 64-bit hash only speeds up the probe
+    struct archetype_signature_hash
+    {
+        uint64_t operator()(archetype_signature_t signature) const noexcept
+        {
+            uint64_t hash = signature.size();
+            for(auto const* component_type : signature)
+            {
+                hash = hash_combine64(hash, get_type_name_hash(component_type));
+            }
+            return hash;
+        }
+
+        uint64_t operator()(archetype_t const* archetype) const noexcept
+        {
+            return archetype->hash;
+        }
+    };
+
+    struct archetype_signature_equal
+    {
+        bool operator()(archetype_t const* archetype, archetype_signature_t signature) const noexcept
+        {
+            return std::ranges::equal(archetype->component_types, signature);
+        }
+
+        bool operator()(archetype_t const* lhs, archetype_t const* rhs) const noexcept
+        {
+            return lhs == rhs || operator()(lhs, archetype_signature_t{ rhs->component_types });
+        }
+    };
+
     class archetype_registry_impl final : public archetype_registry_t
     {
     public:
         using spin_lock_t = async_simple::coro::SpinLock;
         using scoped_spin_lock_t = async_simple::coro::ScopedSpinLock;
-        using archetype_container = std::unordered_map<uint32_t, archetype_weak>;
+        static constexpr size_t shard_count = PUNK_ARCHETYPE_REGISTRY_SHARD_COUNT;
+        static_assert(std::has_single_bit(shard_count));
 
     private:
-        archetype_container all_archetypes;
-        spin_lock_t         archetype_lock;
+        // a registered archetype, immutable once published & retired through the epoch domain when replaced
+        struct archetype_node_t
+        {
+            archetype_t const*              archetype;
+            archetype_weak                  weak;
+        };
+
+        // the node is published after the hash, a null node ends a probe
+        struct archetype_slot_t
+        {
+            std::atomic<uint64_t>           hash{ 0 };
+            std::atomic<archetype_node_t*>  node{ nullptr };
+        };
+
+        // open addressing with linear probing, writers insert in place & leave tombstones on removal
+        // a full table is rebuilt without tombstones, published, & the old one retired
+        struct archetype_table_t
+        {
+            size_t                              mask;
+            size_t                              used;       // live & tombstone slots, writers only
+            std::unique_ptr<archetype_slot_t[]> slots;
+        };
+
+        // archetypes are sharded by signature hash, writers of one shard never block the others & readers never lock
+        struct alignas(64) archetype_shard_t
+        {
+            std::atomic<archetype_table_t*> table{ nullptr };
+            spin_lock_t                     lock;
+            std::atomic<uint64_t>           archetype_count{ 0 };
+            std::atomic<uint64_t>           lock_acquisitions{ 0 };
+            std::atomic<uint64_t>           lock_contentions{ 0 };
+            std::atomic<uint64_t>           table_rebuilds{ 0 };
+        };
+
+        static inline archetype_node_t tombstone_node{};
+        static constexpr uint32_t shard_bits = std::countr_zero(shard_count);
+
+        std::array<archetype_shard_t, shard_count> archetype_shards;
 
     public:
         explicit archetype_registry_impl(runtime_type_registry_t* runtime_type_registry_t);
+        ~archetype_registry_impl() override;
 
-        virtual archetype_ptr get_archetype(uint32_t hash) override;
+        virtual archetype_ptr get_archetype(uint64_t hash) override;
+        virtual archetype_handle_t find_archetype_handle(uint64_t hash) override;
+        virtual void for_each_archetype(std::function<void(archetype_ptr const&)> const& func) override;
+        virtual archetype_registry_stats_t get_stats() const override;
+        virtual void reset_stats() override;
 
     protected:
         virtual archetype_ptr get_or_create_archetype_impl(type_info_t const** sorted_component_types, size_t component_count) override;
-        virtual archetype_ptr archetype_include_components_impl(archetype_ptr const& archetype, 
-            size_t component_count, type_info_t const** component_types, uint32_t* include_orders) override;
-        virtual archetype_ptr archetype_exclude_components_impl(archetype_ptr const& archetype,type_info_t const** component_types, size_t component_count) override;
+        virtual archetype_ptr archetype_include_components_impl(archetype_ptr const& archetype, type_info_t const** sorted_component_types, size_t component_count) override;
+        virtual archetype_ptr archetype_exclude_components_impl(archetype_ptr const& archetype, type_info_t const** sorted_component_types, size_t component_count) override;
 
     private:
-        archetype_ptr allocate_archetype(uint32_t hash, size_t component_count);
+        archetype_shard_t& get_shard(uint64_t hash) noexcept { return archetype_shards[hash & (shard_count - 1)]; }
+        std::unique_lock<spin_lock_t> lock_shard(archetype_shard_t& shard);
+
+        // lock-free, the caller must be pinned
+        template <typename Pred>
+        static archetype_slot_t* find_slot(archetype_table_t const* table, uint64_t hash, Pred&& pred) noexcept
+        {
+            if(!table)
+            {
+                return nullptr;
+            }
+
+            // the low bits picked the shard
+            for(auto index = (hash >> shard_bits) & table->mask; ; index = (index + 1) & table->mask)
+            {
+                auto& slot = table->slots[index];
+                auto const* node = slot.node.load(std::memory_order_acquire);
+                if(!node)
+                {
+                    return nullptr;
+                }
+                if(node != &tombstone_node && slot.hash.load(std::memory_order_relaxed) == hash && pred(node->archetype))
+                {
+                    return &slot;
+                }
+            }
+        }
+
+        // hash only probe, the first archetype with the hash, no other live one may share it
+        static archetype_slot_t* find_slot_by_hash(archetype_table_t const* table, uint64_t hash) noexcept
+        {
+            assert(count_slots(table, hash) <= 1 && "archetype hash collision, look the archetype up by its signature");
+            return find_slot(table, hash, [](archetype_t const*) { return true; });
+        }
+
+        static uint32_t count_slots(archetype_table_t const* table, uint64_t hash) noexcept
+        {
+            uint32_t count = 0;
+            find_slot(table, hash, [&count](archetype_t const*) { ++count; return false; });
+            return count;
+        }
+
+        // under the shard lock
+        void insert_node(archetype_shard_t& shard, uint64_t hash, archetype_node_t* node);
+        archetype_table_t* rebuild_table(archetype_shard_t& shard, archetype_table_t* table);
+
+        archetype_ptr find_archetype(archetype_signature_t signature, uint64_t hash);
+        archetype_ptr allocate_archetype(uint64_t hash, size_t component_count);
         void destroy_archetype(archetype_t* archetype);
         archetype_ptr register_archetype(archetype_ptr& archetype);
         void unregister_archetype(archetype_t* archetype);
         void initialize_archetype(archetype_t* archetype, type_info_t const** component_types, size_t count);
         void search_chunck_offset_and_capacity(archetype_t* archetype);
-        uint32_t calculate_chunk_size_and_offsets(archetype_t* archetype, uint32_t capacity, std::vector<uint32_t>& offsets);
     };
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "ECS/Archetype/Prefab.h"
+
+namespace punk
+{
+    namespace
+    {
+        constexpr std::align_val_t prefab_image_alignment{ alignof(std::max_align_t) };
+    }
+
+    prefab_t::prefab_t(archetype_ptr archetype)
+        : archetype_(std::move(archetype))
+    {
+        assert(archetype_);
+        auto const& component_types = archetype_->component_types;
+
+        // one aligned slot per column, tags get an empty slot
+        uint32_t image_size = 0;
+        value_offsets_.reserve(component_types.size());
+        for(auto const* component_type : component_types)
+        {
+            auto const size = is_tag_component(component_type) ? 0 : get_type_size(component_type);
+            auto const align = (std::max)(get_type_align(component_type), uint32_t{ 1 });
+            assert(align <= static_cast<uint32_t>(prefab_image_alignment));
+            image_size = (image_size + align - 1) / align * align;
+            value_offsets_.push_back(image_size);
+            image_size += size;
+        }
+
+        image_ = static_cast<std::byte*>(::operator new((std::max)(image_size, uint32_t{ 1 }), prefab_image_alignment));
+        for(uint32_t column = 0; column < component_types.size(); ++column)
+        {
+            construct_objects(component_types[column], get_value(column), 1);
+        }
+    }
+
+    prefab_t::~prefab_t()
+    {
+        for(uint32_t column = 0; column < archetype_->component_types.size(); ++column)
+        {
+            destroy_objects(archetype_->component_types[column], get_value(column), 1);
+        }
+        ::operator delete(image_, prefab_image_alignment);
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "ECS/CoreTypes.h"
+
+namespace punk
+{
+    // a pre-built row of an archetype, every spawned entity starts as a copy of it
+    // the image holds one value per column with storage, shared columns included, tags hold nothing
+    // entity references are entity_t fields that point at the entity itself, they are patched per spawned row
+    class prefab_t
+    {
+    public:
+        struct entity_reference_t
+        {
+            uint32_t    column;
+            uint32_t    offset_in_component;
+        };
+
+    private:
+        archetype_ptr                   archetype_;
+        std::byte*                      image_ = nullptr;
+        vector<uint32_t>                value_offsets_;
+        vector<entity_reference_t>      entity_references_;
+
+    public:
+        // the image starts with value initialized components
+        explicit prefab_t(archetype_ptr archetype);
+        ~prefab_t();
+
+        prefab_t(prefab_t const&) = delete;
+        prefab_t& operator=(prefab_t const&) = delete;
+
+    public:
+        archetype_ptr const& get_archetype() const noexcept { return archetype_; }
+
+        void* get_value(uint32_t column) noexcept
+        {
+            assert(column < value_offsets_.size());
+            return image_ + value_offsets_[column];
+        }
+
+        void const* get_value(uint32_t column) const noexcept
+        {
+            return const_cast<prefab_t*>(this)->get_value(column);
+        }
+
+        // the value of a component, nullptr when the archetype does not have it
+        template <typename T>
+        T* get(runtime_type_registry_t* runtime_type_registry) noexcept
+        {
+            auto const column = find_archetype_component(archetype_.get(), runtime_type_registry->get_or_create_type_info<T>());
+            return column != invalid_index_value() ? static_cast<T*>(get_value(column)) : nullptr;
+        }
+
+        // marks an entity_t field that must hold the spawned entity
+        void add_entity_reference(uint32_t column, uint32_t offset_in_component)
+        {
+            assert(column < value_offsets_.size());
+            assert(offset_in_component + sizeof(entity_t) <= get_type_size(archetype_->component_types[column]));
+            entity_references_.push_back({ column, offset_in_component });
+        }
+
+        std::span<entity_reference_t const> get_entity_references() const noexcept { return entity_references_; }
+    };
+}
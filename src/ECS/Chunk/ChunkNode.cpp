@@ -2,16 +2,17 @@
 
 namespace punk
 {
-    chunk_root_node::chunk_root_node(uint32_t archetype_hash, size_t preallocate_chunk_count)
+    chunk_root_node::chunk_root_node(uint64_t archetype_hash, size_t preallocate_chunk_count)
         : archetype_hash_(archetype_hash)
         , chunk_head_(nullptr)
         , chunk_tail_(nullptr)
         , free_chunk_head_(nullptr)
+        , chunk_count_(0)
     {
+        // preallocated chunks wait in the free list until acquire_chunk sets them up
         for (size_t i = 0; i < preallocate_chunk_count; ++i)
         {
-            auto* node = allocate_chunk_node();
-            insert_chunk_node(node);
+            free_chunk_node(allocate_chunk_node());
         }
     }
 
@@ -20,6 +21,45 @@ namespace punk
         clear();
     }
 
+    chunk_root_node::chunk_root_node(chunk_root_node&& other) noexcept
+        : archetype_hash_(other.archetype_hash_)
+        , chunk_head_(std::exchange(other.chunk_head_, nullptr))
+        , chunk_tail_(std::exchange(other.chunk_tail_, nullptr))
+        , free_chunk_head_(std::exchange(other.free_chunk_head_, nullptr))
+        , chunk_count_(std::exchange(other.chunk_count_, 0))
+    {
+    }
+
+    chunk_root_node& chunk_root_node::operator=(chunk_root_node&& other) noexcept
+    {
+        if(this != &other)
+        {
+            clear();
+            archetype_hash_ = other.archetype_hash_;
+            chunk_head_ = std::exchange(other.chunk_head_, nullptr);
+            chunk_tail_ = std::exchange(other.chunk_tail_, nullptr);
+            free_chunk_head_ = std::exchange(other.free_chunk_head_, nullptr);
+            chunk_count_ = std::exchange(other.chunk_count_, 0);
+        }
+        return *this;
+    }
+
+    void chunk_root_node::release_chunk(chunk_t* chunk)
+    {
+        assert(chunk && chunk->element_count == 0);
+        for(auto* node = chunk_head_; node; node = node->next)
+        {
+            if(node->chunk == chunk)
+            {
+                remove_chunk_node(node);
+                free_chunk_node(node);
+                --chunk_count_;
+                return;
+            }
+        }
+        assert(false && "chunk does not belong to this archetype");
+    }
+
     chunk_node_t* chunk_root_node::allocate_chunk_node()
     {
         chunk_node_t* node = nullptr;
@@ -82,11 +122,48 @@ namespace punk
 
     void chunk_root_node::remove_chunk_node(chunk_node_t* node)
     {
+        if (!node)
+        {
+            return;
+        }
 
+        if (node->prev)
+        {
+            node->prev->next = node->next;
+        }
+        else
+        {
+            chunk_head_ = node->next;
+        }
+
+        if (node->next)
+        {
+            node->next->prev = node->prev;
+        }
+        else
+        {
+            chunk_tail_ = node->prev;
+        }
+        node->next = nullptr;
+        node->prev = nullptr;
     }
 
     void chunk_root_node::clear()
     {
-
+        // rows are destroyed by the owner, only the memory is released here
+        for (auto* list : { chunk_head_, free_chunk_head_ })
+        {
+            while (list)
+            {
+                auto* next = list->next;
+                std::free(list->chunk);
+                delete list;
+                list = next;
+            }
+        }
+        chunk_head_ = nullptr;
+        chunk_tail_ = nullptr;
+        free_chunk_head_ = nullptr;
+        chunk_count_ = 0;
     }
 }
\ No newline at end of file
@@ -16,18 +16,57 @@ namespace punk
     class chunk_root_node : public std::enable_shared_from_this<chunk_root_node>
     {
     private:
-        uint32_t        archetype_hash_;
+        uint64_t        archetype_hash_;
         chunk_node_t*   chunk_head_;
         chunk_node_t*   chunk_tail_;
         chunk_node_t*   free_chunk_head_;
+        uint32_t        chunk_count_;
 
     public:
-        chunk_root_node(uint32_t archetype_hash, size_t preallocate_chunk_count);
+        chunk_root_node(uint64_t archetype_hash, size_t preallocate_chunk_count);
         ~chunk_root_node();
         chunk_root_node(chunk_root_node const&) = delete;
         chunk_root_node& operator=(chunk_root_node const&) = delete;
-        chunk_root_node(chunk_root_node&&) = default;
-        chunk_root_node& operator=(chunk_root_node&&) = default;
+        chunk_root_node(chunk_root_node&& other) noexcept;
+        chunk_root_node& operator=(chunk_root_node&& other) noexcept;
+
+    public:
+        // first chunk in use with a free row accepted by pred, or a fresh one set up by init
+        template <typename Pred, typename Init>
+        chunk_t* acquire_chunk(uint32_t capacity, Pred&& pred, Init&& init)
+        {
+            for(auto* node = chunk_head_; node; node = node->next)
+            {
+                if(node->chunk->element_count < capacity && pred(static_cast<chunk_t const*>(node->chunk)))
+                {
+                    return node->chunk;
+                }
+            }
+
+            auto* node = allocate_chunk_node();
+            auto* chunk = node->chunk;
+            chunk->archetype_hash = archetype_hash_;
+            chunk->element_count = 0;
+            chunk->chunk_number = chunk_count_++;
+            init(chunk);
+            insert_chunk_node(node);
+            return chunk;
+        }
+
+        // returns an empty chunk to the free list
+        void release_chunk(chunk_t* chunk);
+
+        size_t get_chunk_count() const noexcept { return chunk_count_; }
+
+        // func(chunk_t*) for every chunk in use, in list order
+        template <typename Func>
+        void for_each_chunk(Func&& func) const
+        {
+            for(auto const* node = chunk_head_; node; node = node->next)
+            {
+                func(node->chunk);
+            }
+        }
 
     private:
         chunk_node_t* allocate_chunk_node();
@@ -6,12 +6,14 @@ namespace punk
 {
     struct chunk_t
     {
-        static constexpr size_t chunke_size = 16 * 1024;
+        static constexpr size_t chunke_size = chunk_size_in_bytes;
 
-        uint32_t                        archetype_hash;
+        uint64_t                        archetype_hash;
         uint32_t                        element_count;
         uint32_t                        chunk_number;
     };
+    static_assert(sizeof(chunk_t) == chunk_header_size_in_bytes, "chunk layout assumes a fixed header size");
+    static_assert(sizeof(entity_t) == chunk_entity_size_in_bytes && alignof(entity_t) <= alignof(uint64_t), "chunk layout assumes 64-bit entities");
 
     // data index in one chunk
     using chunk_index_t = handle<chunk_t, uint32_t>;
@@ -39,12 +41,19 @@ namespace punk
     struct component_info_t
     {
         uint32_t                        offset_in_chunk;
+        // invalid_offset_value() unless the component is enableable
+        uint32_t                        enable_mask_offset;
+        // version of the last write to the column, invalid_offset_value() for tags
+        uint32_t                        change_version_offset;
     };
 
     struct archetype_t
     {
-        uint32_t                        hash;
+        // hash of the sorted component signature
+        uint64_t                        hash;
         uint16_t                        capacity_in_chunk;
+        // entity of every row, from the chunk base
+        uint32_t                        entities_offset;
         bool                            registered;
         vector<type_info_t const*>      component_types;
         vector<component_info_t>        component_infos;
@@ -1,27 +1,29 @@
 #include "ECS/Entity/EntityPool.h"
+#include <thread>
 
 namespace punk
 {
     entity_t entity_pool_impl_t::allocate_entity()
     {
-        uint32_t index = 0, version = 0;
-        {
-            scoped_spin_lock_t lock{ spin_lock_ };
-            auto [version_ptr, idx] = entities_version_.construct();
-            assert(version_ptr);
-            version = version_ptr->version++;
-            index = static_cast<uint32_t>(idx);
-        }
-        return entity_t::compose(entity_handle_t{ index }, version);
+        // the version survives in the slot, it is bumped when the entity is deallocated
+        auto [version_ptr, index] = entities_version_.revive();
+        assert(version_ptr);
+        return entity_t::compose(entity_handle_t{ static_cast<uint32_t>(index) }, version_ptr->version);
     }
 
     void entity_pool_impl_t::deallocate_entity(entity_t entity)
     {
         auto const handle = entity.get_handle();
         auto const version = entity.get_version();
-        scoped_spin_lock_t lock{ spin_lock_ };
         auto const version_ptr = entities_version_.get(handle.get_value());
-        if(version_ptr && version_ptr->version == version)
+        if(!version_ptr)
+        {
+            return;
+        }
+
+        // only the thread bumping the version releases the slot
+        auto expected = version;
+        if(std::atomic_ref<uint32_t>{ version_ptr->version }.compare_exchange_strong(expected, version + 1))
         {
             entities_version_.destruct(handle.get_value());
         }
@@ -31,20 +33,26 @@ namespace punk
     {
         auto const handle = entity.get_handle();
         auto const version = entity.get_version();
-        scoped_spin_lock_t lock{ spin_lock_ };
         auto const version_ptr = entities_version_.get(handle.get_value());
-        return version_ptr && version_ptr->version == version;
+        return version_ptr && std::atomic_ref<uint32_t>{ version_ptr->version }.load() == version;
     }
 
     entity_t entity_pool_impl_t::restore_entity(entity_handle_t handle)
     {
-        scoped_spin_lock_t lock{ spin_lock_ };
-        auto [version_ptr, _] = entities_version_.construct_at(handle.get_value(), false);
-        return entity_t::compose(handle, version_ptr->version);
+        // another thread may be between claiming & publishing the slot or between retiring & releasing it, both settle
+        for(;;)
+        {
+            auto [version_ptr, _] = entities_version_.revive_at(handle.get_value());
+            if(version_ptr)
+            {
+                return entity_t::compose(handle, version_ptr->version);
+            }
+            std::this_thread::yield();
+        }
     }
 
     entity_pool_t* entity_pool_t::create_entity_pool()
     {
         return new entity_pool_impl_t{};
     }
-}
\ No newline at end of file
+}
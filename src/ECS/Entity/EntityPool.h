@@ -1,8 +1,7 @@
 #pragma once
 
 #include "ECS/CoreTypes.h"
-#include "Base/Containers/Hive.h"
-#include "Base/Async/Async.h"
+#include "Base/Containers/ConcurrentHive.h"
 
 namespace punk
 {
@@ -14,9 +13,6 @@ namespace punk
 
     class entity_pool_impl_t : public entity_pool_t
     {
-        using spin_lock_t = async_simple::coro::SpinLock;
-        using scoped_spin_lock_t = async_simple::coro::ScopedSpinLock;
-
     public:
         virtual entity_t allocate_entity() override;
         virtual void deallocate_entity(entity_t entity) override;
@@ -24,7 +20,7 @@ namespace punk
         virtual entity_t restore_entity(entity_handle_t handle) override;
 
     private:
-        spin_lock_t             spin_lock_;
-        hive<entity_version_t>  entities_version_;
+        // producers on worker threads claim handles without a global lock
+        concurrent_hive<entity_version_t>   entities_version_;
     };
-}
\ No newline at end of file
+}
@@ -56,6 +56,17 @@ namespace punk
         return get_type_hash(type_info).value0;
     }
 
+    bool type_info_less(type_info_t const* lhs, type_info_t const* rhs)
+    {
+        auto const lhs_hash = get_type_name_hash(lhs);
+        auto const rhs_hash = get_type_name_hash(rhs);
+        if(lhs_hash != rhs_hash)
+        {
+            return lhs_hash < rhs_hash;
+        }
+        return std::string_view{ get_type_name(lhs) } < std::string_view{ get_type_name(rhs) };
+    }
+
     // get field count
     uint32_t get_type_field_count(type_info_t const* type_info)
     {
@@ -92,6 +103,21 @@ namespace punk
         return type_info ? type_info->component_group : 0;
     }
 
+    bool is_tag_component(type_info_t const* type_info)
+    {
+        return type_info && type_info->vtable.empty;
+    }
+
+    bool is_shared_component(type_info_t const* type_info)
+    {
+        return type_info && type_info->component_tag == component_tag_t::shared;
+    }
+
+    bool is_enableable_component(type_info_t const* type_info)
+    {
+        return type_info && type_info->component_tag == component_tag_t::enableable;
+    }
+
     void update_hash_for_fields(type_info_t* type_info)
     {
         std::vector<type_hash_t> all_fileds_type_hash{};
@@ -105,6 +131,97 @@ namespace punk
         type_info->hash.value1 = hash_memory(
             reinterpret_cast<char const*>(all_fileds_type_hash.data()), all_fileds_type_hash.size() * sizeof(type_hash_t));
     }
+
+    void construct_objects(type_info_t const* type_info, void* dst, size_t count)
+    {
+        assert(type_info);
+        if(type_info->vtable.empty)
+        {
+            // a tag column has no storage to touch
+            return;
+        }
+        else if(type_info->vtable.construct_n)
+        {
+            type_info->vtable.construct_n(dst, count);
+        }
+        else
+        {
+            // trivial types are value initialized
+            std::memset(dst, 0, type_info->size * count);
+        }
+    }
+
+    void destroy_objects(type_info_t const* type_info, void* dst, size_t count)
+    {
+        assert(type_info);
+        if(!type_info->vtable.empty && type_info->vtable.destroy_n)
+        {
+            type_info->vtable.destroy_n(dst, count);
+        }
+    }
+
+    void copy_objects(type_info_t const* type_info, void* dst, void const* src, size_t count)
+    {
+        assert(type_info);
+        if(type_info->vtable.empty)
+        {
+            return;
+        }
+        else if(type_info->vtable.trivially_copyable)
+        {
+            std::memcpy(dst, src, type_info->size * count);
+        }
+        else
+        {
+            type_info->vtable.copy_n(dst, src, count);
+        }
+    }
+
+    void relocate_objects(type_info_t const* type_info, void* dst, void* src, size_t count)
+    {
+        assert(type_info);
+        if(type_info->vtable.empty)
+        {
+            return;
+        }
+        else if(type_info->vtable.trivially_relocatable)
+        {
+            std::memmove(dst, src, type_info->size * count);
+        }
+        else
+        {
+            type_info->vtable.relocate_n(dst, src, count);
+        }
+    }
+
+    void fill_objects(type_info_t const* type_info, void* dst, void const* src, size_t count)
+    {
+        assert(type_info);
+        if(type_info->vtable.empty || count == 0)
+        {
+            return;
+        }
+        else if(type_info->vtable.trivially_copyable)
+        {
+            // one object, then the filled prefix copied onto the rest, log2(count) memcpys
+            auto* bytes = static_cast<std::byte*>(dst);
+            size_t const size = type_info->size;
+            std::memcpy(bytes, src, size);
+            for(size_t filled = 1; filled < count; filled *= 2)
+            {
+                std::memcpy(bytes + filled * size, bytes, (std::min)(filled, count - filled) * size);
+            }
+        }
+        else
+        {
+            construct_objects(type_info, dst, count);
+            auto* bytes = static_cast<std::byte*>(dst);
+            for(size_t index = 0; index < count; ++index)
+            {
+                type_info->vtable.copy_func(bytes + index * type_info->size, src);
+            }
+        }
+    }
 }
 
 namespace punk
@@ -135,3 +252,70 @@ namespace punk
         return field_info ? field_info->offset : invalid_offset_value();
     }
 }
+
+namespace punk
+{
+    uint64_t get_archetype_hash(archetype_t const* archetype)
+    {
+        return archetype ? archetype->hash : 0u;
+    }
+
+    uint32_t get_archetype_component_count(archetype_t const* archetype)
+    {
+        return archetype ? static_cast<uint32_t>(archetype->component_types.size()) : 0u;
+    }
+
+    uint32_t get_archetype_capacity(archetype_t const* archetype)
+    {
+        return archetype ? archetype->capacity_in_chunk : 0u;
+    }
+
+    uint32_t find_archetype_component(archetype_t const* archetype, type_info_t const* component_type)
+    {
+        if(!archetype || !component_type)
+        {
+            return invalid_index_value();
+        }
+
+        // components are sorted by type_info_less
+        auto const itr = std::ranges::lower_bound(archetype->component_types, component_type, type_info_less);
+        return itr != archetype->component_types.end() && *itr == component_type
+            ? static_cast<uint32_t>(std::distance(archetype->component_types.begin(), itr))
+            : invalid_index_value();
+    }
+
+    uint32_t get_archetype_component_offset(archetype_t const* archetype, uint32_t column)
+    {
+        assert(archetype && column < archetype->component_infos.size());
+        return archetype->component_infos[column].offset_in_chunk;
+    }
+
+    uint32_t get_archetype_entities_offset(archetype_t const* archetype)
+    {
+        assert(archetype);
+        return archetype->entities_offset;
+    }
+
+    uint32_t get_archetype_enable_mask_offset(archetype_t const* archetype, uint32_t column)
+    {
+        assert(archetype && column < archetype->component_infos.size());
+        return archetype->component_infos[column].enable_mask_offset;
+    }
+
+    uint32_t get_archetype_change_version_offset(archetype_t const* archetype, uint32_t column)
+    {
+        assert(archetype && column < archetype->component_infos.size());
+        return archetype->component_infos[column].change_version_offset;
+    }
+
+    void const* get_chunk_shared_value(archetype_t const* archetype, chunk_t const* chunk, uint32_t column)
+    {
+        assert(chunk && is_shared_component(archetype->component_types[column]));
+        return reinterpret_cast<std::byte const*>(chunk) + get_archetype_component_offset(archetype, column);
+    }
+
+    uint32_t get_chunk_element_count(chunk_t const* chunk)
+    {
+        return chunk ? chunk->element_count : 0u;
+    }
+}
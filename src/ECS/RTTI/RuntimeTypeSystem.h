@@ -1,19 +1,34 @@
 #pragma once
 #include "ECS/CoreTypes.h"
+#include "Base/Containers/ConcurrentLookupTable.h"
+#include "Base/Containers/FlatHashMap.h"
 
 namespace punk
 {
+    struct type_name_hash
+    {
+        uint64_t operator()(std::string_view type_name) const noexcept
+        {
+            return hash_memory64(type_name);
+        }
+    };
+
     class runtime_type_system_impl final : public runtime_type_registry_t
     {
     public:
         using spin_lock_t = async_simple::coro::SpinLock;
         using scoped_spin_lock_t = async_simple::coro::ScopedSpinLock;
         using type_info_ptr = std::unique_ptr<type_info_t>;
-        using type_info_container = std::unordered_map<uint32_t, type_info_ptr>;
+        // owned type infos keyed by their full name, the key views the name stored in the type info
+        using type_info_container = flat_hash_map<std::string_view, type_info_ptr, type_name_hash>;
+        using type_info_lookup_table = concurrent_lookup_table<uint32_t, type_info_t*>;
 
     private:
-        mutable spin_lock_t type_lock;
-        type_info_container runtime_type_infos;
+        // type_lock serializes writers & the name lookups that miss the wait-free table
+        mutable spin_lock_t     type_lock;
+        type_info_container     runtime_type_infos;
+        // first type registered under each 32-bit name hash, a later name sharing the hash is only found by name
+        type_info_lookup_table  type_info_lookup;
 
     public:
         virtual ~runtime_type_system_impl() override = default;
@@ -24,28 +39,24 @@ namespace punk
             {
                 return nullptr;
             }
-            auto const type_name_hash = hash_memory(type_name, std::strlen(type_name));
-            return get_type_info(type_name_hash);
+            if(auto* type_info = match_type_name(get_type_info(hash_memory(type_name, std::strlen(type_name))), type_name))
+            {
+                return type_info;
+            }
+
+            scoped_spin_lock_t lock{ type_lock };
+            return find_type_info_locked(type_name);
         }
 
         virtual type_info_t* get_type_info(uint32_t type_name_hash) const override
         {
-            scoped_spin_lock_t lock{ type_lock };
-            auto itr = runtime_type_infos.find(type_name_hash);
-            if(itr != runtime_type_infos.end())
-            {
-                return itr->second.get();
-            }
-            return nullptr;
+            return type_info_lookup.find(type_name_hash);
         }
 
         virtual type_info_t const* register_type_info(type_info_t* type_info) override
         {
-            auto const type_name_hash = type_info->hash.value0;
             scoped_spin_lock_t lock{ type_lock };
-            auto const emplace_result = runtime_type_infos.emplace(type_name_hash, type_info);
-            return emplace_result.first->second.get();
-            // TODO ... conflict when hash.value1 is not the same
+            return register_type_info_locked(type_info);
         }
 
         virtual Lazy<type_info_t const*> async_get_type_info(char const* type_name) const override
@@ -54,27 +65,51 @@ namespace punk
             {
                 co_return nullptr;
             }
-            auto const type_name_hash = hash_memory(type_name, std::strlen(type_name));
-            co_return co_await async_get_type_info(type_name_hash);
+            if(auto* type_info = match_type_name(type_info_lookup.find(hash_memory(type_name, std::strlen(type_name))), type_name))
+            {
+                co_return type_info;
+            }
+
+            auto scope = co_await type_lock.coScopedLock();
+            co_return find_type_info_locked(type_name);
         }
 
         virtual Lazy<type_info_t const*> async_get_type_info(uint32_t type_name_hash) const override
         {
-            auto scope = type_lock.coScopedLock();
-            auto itr = runtime_type_infos.find(type_name_hash);
-            if (itr != runtime_type_infos.end())
-            {
-                co_return itr->second.get();
-            }
-            co_return nullptr;
+            co_return type_info_lookup.find(type_name_hash);
         }
 
         virtual Lazy<type_info_t const*> async_register_type_info(type_info_t* type_info) override
         {
-            auto const type_name_hash = type_info->hash.value0;
-            auto scope = type_lock.coScopedLock();
-            auto const emplace_result = runtime_type_infos.emplace(type_name_hash, type_info);
-            co_return emplace_result.first->second.get();
+            auto scope = co_await type_lock.coScopedLock();
+            co_return register_type_info_locked(type_info);
+        }
+
+    private:
+        static type_info_t* match_type_name(type_info_t* type_info, std::string_view type_name) noexcept
+        {
+            // a different name sharing the 32-bit hash is never returned
+            return type_info && type_info->name == type_name ? type_info : nullptr;
+        }
+
+        type_info_t* find_type_info_locked(std::string_view type_name) const
+        {
+            auto const* entry = runtime_type_infos.find(type_name);
+            return entry ? entry->second.get() : nullptr;
+        }
+
+        // the caller keeps ownership of type_info unless it is returned
+        type_info_t* register_type_info_locked(type_info_t* type_info)
+        {
+            if(auto* existing = find_type_info_locked(type_info->name))
+            {
+                return existing;
+            }
+
+            runtime_type_infos.try_emplace(std::string_view{ type_info->name }, type_info);
+            // publish to lock-free readers once fully constructed, keeps the earlier type when the hash is taken
+            type_info_lookup.insert(type_info->hash.value0, type_info);
+            return type_info;
         }
     };
 }
\ No newline at end of file
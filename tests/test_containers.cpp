@@ -0,0 +1,392 @@
+#include "gtest/gtest.h"
+#include "Base/Containers/ConcurrentHive.h"
+#include "Base/Containers/DynamicBitset.h"
+#include "Base/Containers/RankSelectBitset.h"
+#include "Base/Containers/ConcurrentLookupTable.h"
+#include "Base/Containers/FlatHashMap.h"
+#include "Base/Utils/Hash.h"
+#include <thread>
+#include <random>
+
+TEST(PunkContainers, ConcurrentHiveSingleThread)
+{
+    punk::concurrent_hive<int> hive;
+    auto [first_ptr, first_index] = hive.construct(1);
+    auto [second_ptr, second_index] = hive.construct(2);
+    ASSERT_NE(first_ptr, nullptr);
+    ASSERT_NE(second_ptr, nullptr);
+    EXPECT_NE(first_index, second_index);
+    EXPECT_EQ(*hive.get(first_index), 1);
+    EXPECT_EQ(*hive.get(second_index), 2);
+
+    EXPECT_TRUE(hive.destruct(first_index));
+    EXPECT_FALSE(hive.destruct(first_index));
+    EXPECT_EQ(hive.get(first_index), nullptr);
+
+    auto [restored_ptr, constructed] = hive.construct_at(1000, false, 3);
+    EXPECT_TRUE(constructed);
+    EXPECT_EQ(*restored_ptr, 3);
+    EXPECT_EQ(hive.get(1000), restored_ptr);
+}
+
+TEST(PunkContainers, ConcurrentHiveRevive)
+{
+    // construct always initializes, revive keeps what the last occupant left
+    punk::concurrent_hive<uint32_t> hive;
+    auto [counter_ptr, index] = hive.revive();
+    ASSERT_NE(counter_ptr, nullptr);
+    EXPECT_EQ(*counter_ptr, 0u);
+    *counter_ptr = 7;
+    EXPECT_TRUE(hive.destruct(index));
+
+    auto [revived_ptr, revived] = hive.revive_at(index);
+    EXPECT_TRUE(revived);
+    EXPECT_EQ(revived_ptr, counter_ptr);
+    EXPECT_EQ(*revived_ptr, 7u);
+    EXPECT_EQ(hive.revive_at(index), std::make_pair(revived_ptr, false));
+
+    EXPECT_TRUE(hive.destruct(index));
+    auto [constructed_ptr, constructed] = hive.construct_at(index, false);
+    EXPECT_TRUE(constructed);
+    EXPECT_EQ(*constructed_ptr, 0u);
+}
+
+TEST(PunkContainers, ConcurrentHiveMultiProducer)
+{
+    constexpr size_t thread_count = 8;
+    constexpr size_t element_per_thread = 4096;
+    punk::concurrent_hive<size_t> hive;
+    std::vector<std::vector<size_t>> indices(thread_count);
+
+    std::vector<std::thread> producers;
+    for(size_t loop = 0; loop < thread_count; ++loop)
+    {
+        producers.emplace_back([&, loop]()
+        {
+            for(size_t element = 0; element < element_per_thread; ++element)
+            {
+                auto const value = loop * element_per_thread + element;
+                auto [ptr, index] = hive.construct(value);
+                indices[loop].push_back(index);
+
+                // churn half of the elements to exercise slot reuse
+                if(element % 2 == 1)
+                {
+                    hive.destruct(indices[loop][element - 1]);
+                }
+            }
+        });
+    }
+    for(auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    std::set<size_t> unique_indices;
+    for(size_t loop = 0; loop < thread_count; ++loop)
+    {
+        for(size_t element = 1; element < element_per_thread; element += 2)
+        {
+            auto const index = indices[loop][element];
+            EXPECT_TRUE(unique_indices.insert(index).second);
+            ASSERT_NE(hive.get(index), nullptr);
+            EXPECT_EQ(*hive.get(index), loop * element_per_thread + element);
+        }
+    }
+}
+
+TEST(PunkContainers, DynamicBitsetBulkOperations)
+{
+    using bitset_t = punk::dynamic_bitset<>;
+    constexpr size_t bit_count = 1000;
+
+    bitset_t lhs{ bit_count, false };
+    bitset_t rhs{ bit_count, false };
+    for(size_t loop = 0; loop < bit_count; loop += 3)
+    {
+        lhs.set(loop);
+    }
+    for(size_t loop = 0; loop < bit_count; loop += 6)
+    {
+        rhs.set(loop);
+    }
+
+    EXPECT_EQ(lhs.count(), 334u);
+    EXPECT_TRUE(lhs.any());
+    EXPECT_TRUE(rhs.is_subset_of(lhs));
+    EXPECT_TRUE(includes(lhs, rhs));
+    EXPECT_FALSE(includes(rhs, lhs));
+    EXPECT_TRUE(intersects(lhs, rhs));
+    EXPECT_EQ((lhs & rhs), rhs);
+    EXPECT_EQ((lhs | rhs), lhs);
+    EXPECT_EQ((lhs ^ rhs).count(), lhs.count() - rhs.count());
+
+    bitset_t all{ bit_count, true };
+    EXPECT_EQ(all.count(), bit_count);
+    EXPECT_TRUE(all.all());
+    EXPECT_TRUE((~all).none());
+    EXPECT_FALSE(intersects(~lhs, rhs));
+
+    // every kernel level this cpu supports agrees with the scalar kernels, at any length & alignment
+    std::mt19937_64 engine{ 42 };
+    std::vector<uint64_t> lhs_words(72), rhs_words(72);
+    std::ranges::generate(lhs_words, [&]() { return engine() & engine(); });
+    std::ranges::generate(rhs_words, [&]() { return engine() & engine(); });
+    auto const scalar = punk::detail::make_bitset_kernels(punk::detail::bitset_kernel_level::scalar);
+    auto const detected_level = static_cast<uint8_t>(punk::detail::detect_bitset_kernel_level());
+    for(uint8_t level = 0; level <= detected_level; ++level)
+    {
+        auto const kernels = punk::detail::make_bitset_kernels(static_cast<punk::detail::bitset_kernel_level>(level));
+        ASSERT_EQ(static_cast<uint8_t>(kernels.level), level);
+        for(size_t const count : { 0, 1, 2, 3, 4, 5, 7, 8, 9, 31, 64 })
+        {
+            for(size_t const offset : { 0, 1, 3 })
+            {
+                auto const* lhs_data = lhs_words.data() + offset;
+                auto const* rhs_data = rhs_words.data() + offset;
+                EXPECT_EQ(kernels.popcount(lhs_data, count), scalar.popcount(lhs_data, count));
+                EXPECT_EQ(kernels.any(lhs_data, count), scalar.any(lhs_data, count));
+                EXPECT_EQ(kernels.includes(lhs_data, rhs_data, count), scalar.includes(lhs_data, rhs_data, count));
+                EXPECT_EQ(kernels.intersects(lhs_data, rhs_data, count), scalar.intersects(lhs_data, rhs_data, count));
+
+                // a subset & a disjoint set take the other branch of includes & intersects
+                std::vector<uint64_t> subset(lhs_data, lhs_data + count), complement(count);
+                scalar.and_assign(subset.data(), rhs_data, count);
+                std::ranges::transform(subset, complement.begin(), [](uint64_t word) { return ~word; });
+                EXPECT_TRUE(kernels.includes(lhs_data, subset.data(), count));
+                EXPECT_FALSE(kernels.intersects(subset.data(), complement.data(), count));
+
+                std::vector<uint64_t> result(lhs_data, lhs_data + count), expected(lhs_data, lhs_data + count);
+                kernels.and_assign(result.data(), rhs_data, count);
+                scalar.and_assign(expected.data(), rhs_data, count);
+                kernels.or_assign(result.data(), lhs_data + 1, count);
+                scalar.or_assign(expected.data(), lhs_data + 1, count);
+                kernels.xor_assign(result.data(), rhs_data + 1, count);
+                scalar.xor_assign(expected.data(), rhs_data + 1, count);
+                EXPECT_EQ(result, expected);
+            }
+        }
+    }
+}
+
+TEST(PunkContainers, DynamicBitsetShift)
+{
+    punk::dynamic_bitset<> bits{ 200, false };
+    bits.set(0);
+    bits.set(63);
+    bits.set(130);
+
+    auto const left = bits << 70;
+    EXPECT_EQ(left.count(), 2u);
+    EXPECT_TRUE(left.test(70));
+    EXPECT_TRUE(left.test(133));
+
+    auto const right = bits >> 63;
+    EXPECT_EQ(right.count(), 2u);
+    EXPECT_TRUE(right.test(0));
+    EXPECT_TRUE(right.test(67));
+
+    EXPECT_EQ(((bits << 64) >> 64), bits);
+    EXPECT_EQ(((bits << 80) >> 80).count(), 2u);
+    EXPECT_TRUE((bits << 200).none());
+}
+
+TEST(PunkContainers, DynamicBitsetSetBitEnumeration)
+{
+    punk::dynamic_bitset<> bits{ 700, false };
+    std::vector<size_t> const expected{ 1, 5, 63, 64, 300, 511, 699 };
+    for(auto const pos : expected)
+    {
+        bits.set(pos);
+    }
+
+    EXPECT_EQ(bits.find_first(), 1u);
+    EXPECT_EQ(bits.find_next(5), 63u);
+    EXPECT_EQ(bits.find_next(64), 300u);
+    EXPECT_EQ(bits.find_next(699), punk::dynamic_bitset<>::npos);
+
+    std::vector<size_t> iterated;
+    for(auto const pos : bits.set_bits())
+    {
+        iterated.push_back(pos);
+    }
+    EXPECT_EQ(iterated, expected);
+
+    std::vector<size_t> visited;
+    bits.for_each_set([&](size_t pos) { visited.push_back(pos); });
+    EXPECT_EQ(visited, expected);
+
+    // early out
+    visited.clear();
+    bits.for_each_set([&](size_t pos) { visited.push_back(pos); return pos < 63; });
+    EXPECT_EQ(visited, (std::vector<size_t>{ 1, 5, 63 }));
+
+    punk::dynamic_bitset<> const empty_bits{ 128, false };
+    EXPECT_TRUE(empty_bits.set_bits().empty());
+    EXPECT_EQ(empty_bits.find_first(), punk::dynamic_bitset<>::npos);
+}
+
+TEST(PunkContainers, SmallBitset)
+{
+    using small_bitset_t = punk::small_bitset<4>;
+    small_bitset_t bits{ 200, false };
+    bits.set(3);
+    bits.set(199);
+    EXPECT_EQ(bits.count(), 2u);
+
+    // copies stay inline
+    auto copied = bits;
+    EXPECT_EQ(copied, bits);
+    copied.set(100);
+    EXPECT_TRUE(copied.includes(bits));
+    EXPECT_FALSE(bits.includes(copied));
+
+    // growing past the inline capacity spills to the heap and keeps the content
+    copied.resize(1000);
+    copied.set(999);
+    EXPECT_EQ(copied.count(), 4u);
+    EXPECT_EQ(copied.find_next(199), 999u);
+
+    // shares the api with the heap version
+    punk::dynamic_bitset<> heap_bits{ 200, false };
+    heap_bits.set(3);
+    heap_bits.set(199);
+    std::string heap_string, inline_string;
+    heap_bits.to_string(heap_string);
+    bits.to_string(inline_string);
+    EXPECT_EQ(heap_string, inline_string);
+}
+
+TEST(PunkContainers, RankSelectBitset)
+{
+    constexpr size_t bit_count = 5000;
+    punk::rank_select_bitset<> bits{ bit_count };
+    std::vector<bool> reference(bit_count, false);
+    std::mt19937 random{ 42 };
+
+    auto const check = [&]()
+    {
+        size_t rank = 0;
+        for(size_t pos = 0; pos < bit_count; ++pos)
+        {
+            ASSERT_EQ(bits.rank(pos), rank);
+            if(reference[pos])
+            {
+                ASSERT_EQ(bits.select(rank), pos);
+                ++rank;
+            }
+        }
+        EXPECT_EQ(bits.count(), rank);
+        EXPECT_EQ(bits.select(rank), punk::rank_select_bitset<>::npos);
+    };
+
+    check();
+    for(size_t round = 0; round < 4; ++round)
+    {
+        // incremental updates, a mix of sets & resets
+        for(size_t loop = 0; loop < 1500; ++loop)
+        {
+            auto const pos = random() % bit_count;
+            auto const value = (random() % 3) != 0;
+            bits.set(pos, value);
+            reference[pos] = value;
+        }
+        check();
+    }
+}
+
+TEST(PunkContainers, ConcurrentLookupTable)
+{
+    constexpr uint32_t key_count = 10000;
+    std::vector<uint32_t> values(key_count);
+    punk::concurrent_lookup_table<uint32_t, uint32_t*> table{ 8 };
+
+    // readers run while the single writer grows the table
+    std::atomic<bool> done{ false };
+    std::vector<std::thread> readers;
+    for(size_t loop = 0; loop < 4; ++loop)
+    {
+        readers.emplace_back([&]()
+        {
+            while(!done.load())
+            {
+                for(uint32_t key = 0; key < key_count; key += 97)
+                {
+                    auto* value = table.find(key * 7919u);
+                    ASSERT_TRUE(value == nullptr || value == &values[key]);
+                }
+            }
+        });
+    }
+
+    for(uint32_t key = 0; key < key_count; ++key)
+    {
+        EXPECT_EQ(table.insert(key * 7919u, &values[key]), &values[key]);
+    }
+    done.store(true);
+    for(auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_EQ(table.size(), key_count);
+    EXPECT_EQ(table.insert(0, &values[1]), &values[0]);
+    for(uint32_t key = 0; key < key_count; ++key)
+    {
+        EXPECT_EQ(table.find(key * 7919u), &values[key]);
+    }
+    EXPECT_EQ(table.find(1), nullptr);
+}
+
+TEST(PunkContainers, FlatHashMap)
+{
+    struct string_hash
+    {
+        uint64_t operator()(std::string_view str) const noexcept { return punk::murmur_fmix64(punk::hash_memory(str)); }
+    };
+    // every key lands on the same hash, only the key comparison tells them apart
+    struct colliding_hash
+    {
+        uint64_t operator()(int) const noexcept { return 42; }
+    };
+
+    punk::flat_hash_map<std::string, int, string_hash> map;
+    for(int loop = 0; loop < 1000; ++loop)
+    {
+        auto [entry, inserted] = map.try_emplace(std::to_string(loop), loop);
+        EXPECT_TRUE(inserted);
+        EXPECT_EQ(entry->second, loop);
+    }
+    EXPECT_EQ(map.size(), 1000);
+    EXPECT_FALSE(map.try_emplace(std::string{ "7" }, 0).second);
+    EXPECT_EQ(map.find(std::string_view{ "7" })->second, 7);
+    EXPECT_EQ(map.find(std::string_view{ "1000" }), nullptr);
+
+    for(int loop = 0; loop < 1000; loop += 2)
+    {
+        EXPECT_TRUE(map.erase(std::to_string(loop)));
+    }
+    EXPECT_FALSE(map.erase(std::string{ "0" }));
+    EXPECT_EQ(map.size(), 500);
+    for(int loop = 0; loop < 1000; ++loop)
+    {
+        auto const* entry = map.find(std::to_string(loop));
+        EXPECT_EQ(entry != nullptr, loop % 2 == 1);
+    }
+
+    punk::flat_hash_map<int, int, colliding_hash> colliding;
+    for(int loop = 0; loop < 64; ++loop)
+    {
+        colliding.try_emplace(loop, loop * 10);
+    }
+    EXPECT_TRUE(colliding.erase(5));
+    for(int loop = 0; loop < 64; ++loop)
+    {
+        auto const* entry = colliding.find(loop);
+        ASSERT_EQ(entry != nullptr, loop != 5);
+        if(entry)
+        {
+            EXPECT_EQ(entry->second, loop * 10);
+        }
+    }
+}
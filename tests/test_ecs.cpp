@@ -4,6 +4,8 @@
 #include "DirectXMath.h"
 #include "ECS/ECS.h"
 #include "ECS/CoreTypes.h"
+#include "ECS/Archetype/ArchetypeInstance.h"
+#include <thread>
 
 using punk::entity_handle_t;
 struct transform_group{};
@@ -47,6 +49,52 @@ struct name_component_t
     std::string     name;
 };
 
+struct selected_tag_t
+{
+    using component_tag = punk::data_component_tag;
+};
+
+struct stunned_component_t
+{
+    using component_tag = punk::enableable_component_tag;
+
+    float           remaining;
+};
+
+struct highlight_component_t
+{
+    using component_tag = punk::data_component_tag;
+    using component_storage = punk::sparse_storage_tag;
+
+    uint32_t        color;
+};
+
+struct loot_component_t
+{
+    using component_tag = punk::data_component_tag;
+
+    punk::entity_t  owner;
+    std::string     name;
+};
+
+struct frozen_tag_t
+{
+    using component_tag = punk::enableable_component_tag;
+};
+
+struct game_clock_t
+{
+    double          time = 0.0;
+    float           delta = 0.0f;
+};
+
+struct team_shared_t
+{
+    using component_tag = punk::shared_component_tag;
+
+    uint32_t        team;
+};
+
 TEST(ECS, DummyTest) 
 {
     EXPECT_TRUE(true);
@@ -68,4 +116,883 @@ TEST(ECS, DummyTest)
     >();
 
     std::cout << archetype_ptr->hash << std::endl;
-}
\ No newline at end of file
+}
+TEST(ECS, StaticArchetypeLayout)
+{
+    using static_archetype_t = punk::static_archetype<transform_component_t, aabb_component_t, hierarchy_component_t>;
+    static_assert(static_archetype_t::component_count == 3);
+    static_assert(static_archetype_t::offset_of<aabb_component_t>() % alignof(aabb_component_t) == 0);
+    static_assert(static_archetype_t::offset_of<transform_component_t>() % alignof(transform_component_t) == 0);
+    static_assert(!static_archetype_t::contains<name_component_t>);
+
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    // the compile time layout matches the registry's column by column
+    auto archetype = archetype_system->get_or_create_archetype<aabb_component_t, hierarchy_component_t, transform_component_t>();
+    ASSERT_EQ(archetype->component_types.size(), static_archetype_t::component_count);
+    EXPECT_EQ(archetype->capacity_in_chunk, static_archetype_t::capacity_in_chunk);
+    EXPECT_EQ(archetype->component_types[static_archetype_t::column_of<aabb_component_t>()], rtts->get_or_create_type_info<aabb_component_t>());
+    for(uint32_t column = 0; column < static_archetype_t::component_count; ++column)
+    {
+        EXPECT_EQ(archetype->component_infos[column].offset_in_chunk, static_archetype_t::offset_of_column(column));
+    }
+
+    // typed access through fixed offsets
+    auto* chunk = static_cast<punk::chunk_t*>(std::malloc(punk::chunk_size_in_bytes));
+    for(uint32_t row = 0; row < 4; ++row)
+    {
+        static_archetype_t::get<aabb_component_t>(chunk, row).min = punk::float3{ static_cast<float>(row), 0.0f, 0.0f };
+    }
+    float sum = 0.0f;
+    static_archetype_t::for_each(chunk, 4,
+        [&sum](transform_component_t&, aabb_component_t& aabb, hierarchy_component_t&)
+        {
+            sum += aabb.min.x;
+        });
+    EXPECT_EQ(sum, 6.0f);
+    std::free(chunk);
+}
+
+TEST(ECS, ViewColumns)
+{
+    using transform_view_t = punk::view<aabb_component_t const, transform_component_t>;
+    using bounds_view_t = punk::view<aabb_component_t>;
+    using hierarchy_view_t = punk::view<hierarchy_component_t const, aabb_component_t const>;
+    static_assert(transform_view_t::is_read_only<aabb_component_t>);
+    static_assert(!transform_view_t::is_read_only<transform_component_t>);
+    static_assert(transform_view_t::conflicts_with<bounds_view_t>());
+    static_assert(!transform_view_t::conflicts_with<hierarchy_view_t>());
+
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    transform_view_t transform_view{ rtts.get() };
+    auto const access = transform_view.get_access();
+    EXPECT_EQ(access[0].type, rtts->get_or_create_type_info<aabb_component_t>());
+    EXPECT_TRUE(access[0].read_only);
+    EXPECT_FALSE(access[1].read_only);
+
+    auto archetype = archetype_system->get_or_create_archetype<transform_component_t, aabb_component_t, name_component_t>();
+    auto other_archetype = archetype_system->get_or_create_archetype<aabb_component_t, hierarchy_component_t>();
+    EXPECT_TRUE(transform_view.matches(archetype));
+    EXPECT_FALSE(transform_view.matches(other_archetype));
+
+    auto* chunk = static_cast<punk::chunk_t*>(std::malloc(punk::chunk_size_in_bytes));
+    chunk->element_count = 8;
+    auto const aabb_column = punk::find_archetype_component(archetype.get(), rtts->get_or_create_type_info<aabb_component_t>());
+    auto* aabbs = reinterpret_cast<aabb_component_t*>(reinterpret_cast<std::byte*>(chunk) + archetype->component_infos[aabb_column].offset_in_chunk);
+    for(uint32_t row = 0; row < chunk->element_count; ++row)
+    {
+        aabbs[row].min = punk::float3{ static_cast<float>(row), 0.0f, 0.0f };
+    }
+
+    // one span per column, sized by the chunk
+    EXPECT_TRUE(transform_view.for_each_chunk(archetype, chunk,
+        [aabbs](std::span<aabb_component_t const> bounds, std::span<transform_component_t> transforms)
+        {
+            EXPECT_EQ(bounds.data(), aabbs);
+            EXPECT_EQ(bounds.size(), 8u);
+            EXPECT_EQ(transforms.size(), 8u);
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(transforms.data()) % alignof(transform_component_t), 0u);
+        }));
+
+    float sum = 0.0f;
+    EXPECT_TRUE(transform_view.for_each(archetype, chunk,
+        [&sum](aabb_component_t const& aabb, transform_component_t&)
+        {
+            sum += aabb.min.x;
+        }));
+    EXPECT_EQ(sum, 28.0f);
+    EXPECT_FALSE(transform_view.for_each(other_archetype, chunk, [](auto&...) {}));
+    std::free(chunk);
+}
+
+TEST(ECS, ArchetypeHandle)
+{
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    auto guard = archetype_system->pin();
+    uint64_t hash = 0;
+    punk::archetype_handle_t handle;
+    {
+        auto archetype = archetype_system->get_or_create_archetype<aabb_component_t, hierarchy_component_t>();
+        hash = archetype->hash;
+        handle = archetype_system->find_archetype_handle(hash);
+        EXPECT_EQ(handle.get(), archetype.get());
+        EXPECT_EQ(handle, punk::archetype_handle_t{ archetype });
+    }
+
+    // released by its last owner, no longer found, but the memory stays valid while pinned
+    EXPECT_FALSE(archetype_system->find_archetype_handle(hash).is_valid());
+    EXPECT_EQ(handle->hash, hash);
+}
+
+TEST(ECS, ArchetypeRegistryConcurrentCreate)
+{
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    // every instance creates the same archetypes, they all agree on one object per signature
+    std::array<punk::archetype_ptr, 4> archetypes;
+    std::vector<std::thread> instances;
+    for(size_t instance = 0; instance < archetypes.size(); ++instance)
+    {
+        instances.emplace_back([&, instance]()
+        {
+            for(size_t loop = 0; loop < 1000; ++loop)
+            {
+                auto transient = archetype_system->get_or_create_archetype<aabb_component_t, name_component_t>();
+                archetypes[instance] = archetype_system->get_or_create_archetype<transform_component_t, hierarchy_component_t>();
+            }
+        });
+    }
+    for(auto& instance : instances)
+    {
+        instance.join();
+    }
+
+    for(auto const& archetype : archetypes)
+    {
+        EXPECT_EQ(archetype, archetypes[0]);
+    }
+    auto const stats = archetype_system->get_stats();
+    EXPECT_GE(stats.archetype_count, 1u);
+    EXPECT_LE(stats.archetype_count, 2u);
+    EXPECT_GE(stats.lock_acquisitions, 2u);
+    EXPECT_LE(stats.lock_contentions, stats.lock_acquisitions);
+}
+
+TEST(ECS, TypeNameHashCollision)
+{
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    // two names sharing a 32-bit name hash are still two types
+    static_assert(punk::hash_memory("collide_28634") == punk::hash_memory("collide_49840"));
+    auto register_type = [&](char const* type_name)
+    {
+        punk::type_create_info create_info
+        {
+            .type_name = type_name,
+            .size = sizeof(uint32_t),
+            .alignment = alignof(uint32_t),
+            .vtable = punk::type_info_traits<uint32_t>::get_vtable(),
+            .field_count = 0,
+            .component_tag = punk::component_tag_t::data,
+            .component_group = 0
+        };
+        return rtts->register_type_info(punk::create_type_info(create_info));
+    };
+    auto const* first = register_type("collide_28634");
+    auto const* second = register_type("collide_49840");
+    ASSERT_TRUE(first && second);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(rtts->get_type_info("collide_28634"), first);
+    EXPECT_EQ(rtts->get_type_info("collide_49840"), second);
+    EXPECT_EQ(rtts->get_type_info(punk::hash_memory("collide_49840")), first);
+
+    // the signature order does not depend on the order the components are given in
+    std::array<punk::type_info_t const*, 2> forward{ first, second };
+    std::array<punk::type_info_t const*, 2> backward{ second, first };
+    auto const archetype = archetype_system->get_or_create_archetype(forward.data(), forward.size());
+    ASSERT_TRUE(archetype);
+    EXPECT_EQ(archetype_system->get_or_create_archetype(backward.data(), backward.size()), archetype);
+    EXPECT_NE(punk::find_archetype_component(archetype.get(), first), punk::find_archetype_component(archetype.get(), second));
+
+    auto const first_only = archetype_system->archetype_exclude_components(archetype, &second, 1);
+    ASSERT_TRUE(first_only);
+    EXPECT_EQ(first_only->component_types.size(), 1u);
+    EXPECT_EQ(first_only->component_types[0], first);
+    EXPECT_EQ(archetype_system->archetype_include_components(first_only, 1, &second), archetype);
+}
+
+TEST(ECS, ArchetypeManifestPreload)
+{
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    auto const* transform_type = rtts->get_or_create_type_info<transform_component_t>();
+    auto const* aabb_type = rtts->get_or_create_type_info<aabb_component_t>();
+    auto const text = std::string{ "# level 0\narchetype " } + punk::get_type_name(transform_type) + "\n+ " + punk::get_type_name(aabb_type) + "\narchetype missing_component_t\n";
+
+    punk::archetype_manifest_t manifest;
+    ASSERT_EQ(punk::parse_archetype_manifest(text, manifest), punk::error_code::succeed);
+    ASSERT_EQ(manifest.archetypes.size(), 2u);
+    ASSERT_EQ(manifest.archetypes[0].transitions.size(), 1u);
+
+    punk::vector<punk::archetype_ptr> preloaded;
+    EXPECT_EQ(punk::preload_archetypes(archetype_system.get(), rtts.get(), manifest, preloaded), punk::error_code::unknown_component_type);
+    EXPECT_EQ(preloaded.size(), 2u);
+    EXPECT_EQ(archetype_system->get_stats().archetype_count, 2u);
+
+    // the first frames only hit the registry
+    auto const archetype = archetype_system->get_or_create_archetype<transform_component_t>();
+    auto [target, orders] = archetype_system->archetype_include_components<aabb_component_t>(archetype);
+    EXPECT_EQ(archetype_system->get_stats().archetype_count, 2u);
+    auto const expected = archetype_system->get_or_create_archetype<transform_component_t, aabb_component_t>();
+    EXPECT_EQ(target, expected);
+    EXPECT_EQ(orders[0], punk::find_archetype_component(target.get(), aabb_type));
+    EXPECT_EQ(archetype_system->archetype_exclude_components<aabb_component_t>(target), archetype);
+
+    // a captured manifest survives a text round trip
+    auto const captured = punk::capture_archetype_manifest(archetype_system.get());
+    EXPECT_EQ(captured.archetypes.size(), 2u);
+    punk::archetype_manifest_t reparsed;
+    ASSERT_EQ(punk::parse_archetype_manifest(punk::write_archetype_manifest(captured), reparsed), punk::error_code::succeed);
+    EXPECT_EQ(reparsed.archetypes.size(), captured.archetypes.size());
+    for(size_t index = 0; index < captured.archetypes.size(); ++index)
+    {
+        EXPECT_EQ(reparsed.archetypes[index].component_type_names, captured.archetypes[index].component_type_names);
+    }
+
+    size_t error_line = 0;
+    punk::archetype_manifest_t broken;
+    EXPECT_EQ(punk::parse_archetype_manifest("archetype a\n\nunexpected\n", broken, &error_line), punk::error_code::manifest_syntax_error);
+    EXPECT_EQ(error_line, 3u);
+}
+
+TEST(ECS, TagComponents)
+{
+    using tagged_archetype_t = punk::static_archetype<transform_component_t, aabb_component_t, selected_tag_t>;
+    using untagged_archetype_t = punk::static_archetype<transform_component_t, aabb_component_t>;
+    static_assert(punk::is_tag_component_v<selected_tag_t>);
+    static_assert(tagged_archetype_t::capacity_in_chunk == untagged_archetype_t::capacity_in_chunk);
+
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    // tagging is a different signature with the same rows per chunk
+    auto const* tag_type = rtts->get_or_create_type_info<selected_tag_t>();
+    EXPECT_TRUE(punk::is_tag_component(tag_type));
+    EXPECT_FALSE(punk::is_tag_component(rtts->get_or_create_type_info<aabb_component_t>()));
+    auto untagged = archetype_system->get_or_create_archetype<transform_component_t, aabb_component_t>();
+    auto tagged = archetype_system->get_or_create_archetype<transform_component_t, aabb_component_t, selected_tag_t>();
+    EXPECT_NE(untagged, tagged);
+    EXPECT_EQ(tagged->capacity_in_chunk, untagged->capacity_in_chunk);
+    EXPECT_EQ(tagged->capacity_in_chunk, tagged_archetype_t::capacity_in_chunk);
+    for(uint32_t column = 0; column < tagged_archetype_t::component_count; ++column)
+    {
+        EXPECT_EQ(tagged->component_infos[column].offset_in_chunk, tagged_archetype_t::offset_of_column(column));
+    }
+
+    // column operations never write through a tag
+    std::array<std::byte, 4> guard{};
+    guard.fill(std::byte{ 0x5a });
+    punk::construct_objects(tag_type, guard.data(), guard.size());
+    EXPECT_EQ(guard[0], std::byte{ 0x5a });
+
+    // queries still filter on the tag
+    punk::view<selected_tag_t const, aabb_component_t const> selected_view{ rtts.get() };
+    EXPECT_TRUE(selected_view.matches(tagged));
+    EXPECT_FALSE(selected_view.matches(untagged));
+
+    auto* chunk = static_cast<punk::chunk_t*>(std::malloc(punk::chunk_size_in_bytes));
+    chunk->element_count = 3;
+    uint32_t rows = 0;
+    EXPECT_TRUE(selected_view.for_each(tagged, chunk, [&rows](selected_tag_t const&, aabb_component_t const&) { ++rows; }));
+    EXPECT_EQ(rows, 3u);
+    std::free(chunk);
+}
+
+TEST(ECS, SharedComponents)
+{
+    using shared_archetype_t = punk::static_archetype<aabb_component_t, team_shared_t>;
+    // one value per chunk costs at most one row
+    static_assert(shared_archetype_t::capacity_in_chunk + 1 >= punk::static_archetype<aabb_component_t>::capacity_in_chunk);
+
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    // the shared value takes no row space
+    auto archetype = archetype_system->get_or_create_archetype<aabb_component_t, team_shared_t, name_component_t>();
+    auto unshared = archetype_system->get_or_create_archetype<aabb_component_t, name_component_t>();
+    EXPECT_TRUE(punk::is_shared_component(rtts->get_or_create_type_info<team_shared_t>()));
+    EXPECT_GE(archetype->capacity_in_chunk + 1, unshared->capacity_in_chunk);
+
+    // rows are partitioned into chunks by their shared value
+    punk::archetype_instance instance{ archetype };
+    auto const name_column = punk::find_archetype_component(archetype.get(), rtts->get_or_create_type_info<name_component_t>());
+    auto const team_column = punk::find_archetype_component(archetype.get(), rtts->get_or_create_type_info<team_shared_t>());
+    team_shared_t const red{ 1 }, blue{ 2 };
+    void const* red_values[] = { &red };
+    void const* blue_values[] = { &blue };
+    std::vector<punk::row_location_t> red_rows, blue_rows;
+    for(uint32_t index = 0; index < 3; ++index)
+    {
+        red_rows.push_back(instance.allocate_row(punk::entity_t{ entity_handle_t{ index * 2 } }, red_values));
+        blue_rows.push_back(instance.allocate_row(punk::entity_t{ entity_handle_t{ index * 2 + 1 } }, blue_values));
+        reinterpret_cast<name_component_t*>(instance.get_column(red_rows.back().chunk, name_column))[index].name = "red";
+    }
+    EXPECT_EQ(instance.get_chunk_count(), 2u);
+    EXPECT_EQ(red_rows[2].chunk, red_rows[0].chunk);
+    EXPECT_NE(red_rows[0].chunk, blue_rows[0].chunk);
+    EXPECT_EQ(static_cast<team_shared_t const*>(punk::get_chunk_shared_value(archetype.get(), blue_rows[0].chunk, team_column))->team, 2u);
+
+    // a shared filter skips whole chunks
+    punk::view<team_shared_t const, name_component_t const> red_view{ rtts.get() };
+    red_view.set_shared_filter<team_shared_t const>(red);
+    uint32_t visited = 0;
+    instance.for_each_chunk(
+        [&](punk::chunk_t* chunk)
+        {
+            red_view.for_each(archetype, chunk,
+                [&visited](team_shared_t const& team, name_component_t const& name)
+                {
+                    EXPECT_EQ(team.team, 1u);
+                    EXPECT_EQ(name.name, "red");
+                    ++visited;
+                });
+        });
+    EXPECT_EQ(visited, 3u);
+
+    // the last row fills the hole & an empty chunk is released
+    EXPECT_EQ(instance.free_row(red_rows[0].chunk, 0), 2u);
+    EXPECT_EQ(punk::get_chunk_element_count(red_rows[0].chunk), 2u);
+    for(uint32_t index = 0; index < 3; ++index)
+    {
+        instance.free_row(blue_rows[0].chunk, 0);
+    }
+    EXPECT_EQ(instance.get_chunk_count(), 1u);
+}
+
+TEST(ECS, EnableableComponents)
+{
+    using stunned_archetype_t = punk::static_archetype<aabb_component_t, stunned_component_t>;
+
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    auto archetype = archetype_system->get_or_create_archetype<aabb_component_t, stunned_component_t>();
+    auto const stunned_column = punk::find_archetype_component(archetype.get(), rtts->get_or_create_type_info<stunned_component_t>());
+    EXPECT_EQ(archetype->capacity_in_chunk, stunned_archetype_t::capacity_in_chunk);
+    EXPECT_EQ(punk::get_archetype_enable_mask_offset(archetype.get(), stunned_column), stunned_archetype_t::enable_mask_offset_of<stunned_component_t>());
+    EXPECT_EQ(punk::get_archetype_enable_mask_offset(archetype.get(), 1 - stunned_column), punk::invalid_offset_value());
+
+    punk::archetype_instance instance{ archetype };
+    std::vector<punk::row_location_t> rows;
+    for(uint32_t index = 0; index < 100; ++index)
+    {
+        rows.push_back(instance.allocate_row(punk::entity_t{ entity_handle_t{ index } }));
+        reinterpret_cast<stunned_component_t*>(instance.get_column(rows.back().chunk, stunned_column))[index].remaining = static_cast<float>(index);
+    }
+    ASSERT_EQ(instance.get_chunk_count(), 1u);
+    auto* chunk = rows[0].chunk;
+
+    // toggling writes one bit & the row stays in its chunk
+    instance.set_component_enabled(chunk, 3, stunned_column, false);
+    instance.set_component_enabled(chunk, 70, stunned_column, false);
+    EXPECT_FALSE(instance.is_component_enabled(chunk, 70, stunned_column));
+    EXPECT_TRUE(instance.is_component_enabled(chunk, 71, stunned_column));
+
+    punk::view<stunned_component_t const, aabb_component_t const> stunned_view{ rtts.get() };
+    auto const count_stunned = [&]()
+        {
+            uint32_t visited = 0;
+            stunned_view.for_each(archetype, chunk,
+                [&visited](stunned_component_t const& stunned, aabb_component_t const&)
+                {
+                    EXPECT_NE(stunned.remaining, 3.0f);
+                    EXPECT_NE(stunned.remaining, 70.0f);
+                    ++visited;
+                });
+            return visited;
+        };
+    EXPECT_EQ(count_stunned(), 98u);
+
+    // removing a row carries the enable bit of the last row into the hole
+    instance.set_component_enabled(chunk, 99, stunned_column, false);
+    EXPECT_EQ(instance.free_row(chunk, 10), 99u);
+    EXPECT_FALSE(instance.is_component_enabled(chunk, 10, stunned_column));
+    EXPECT_EQ(count_stunned(), 96u);
+}
+
+TEST(ECS, SparseComponents)
+{
+    static_assert(punk::is_sparse_component_v<highlight_component_t>);
+
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    // the sparse set keeps values dense & rejects stale entities
+    punk::sparse_storage<highlight_component_t> highlights;
+    auto const entity = punk::entity_t{ entity_handle_t{ 5000 }, 1 };
+    highlights.emplace(entity, 7u);
+    highlights.emplace(punk::entity_t{ entity_handle_t{ 3 } }, 8u);
+    EXPECT_EQ(highlights.size(), 2u);
+    EXPECT_EQ(highlights.find(entity)->color, 7u);
+    EXPECT_EQ(highlights.find(punk::entity_t{ entity_handle_t{ 5000 }, 2 }), nullptr);
+    EXPECT_TRUE(highlights.erase(entity));
+    EXPECT_FALSE(highlights.contains(entity));
+    EXPECT_EQ(highlights.find(punk::entity_t{ entity_handle_t{ 3 } })->color, 8u);
+
+    // a reused handle takes over the entry of its older version instead of orphaning it
+    auto const reused = punk::entity_t{ entity_handle_t{ 40 }, 1 };
+    auto const reused_again = punk::entity_t{ entity_handle_t{ 40 }, 2 };
+    auto const neighbour = punk::entity_t{ entity_handle_t{ 41 }, 1 };
+    highlights.emplace(reused, 1u);
+    highlights.emplace(neighbour, 2u);
+    highlights.emplace(reused_again, 3u);
+    EXPECT_EQ(highlights.size(), 3u);
+    EXPECT_FALSE(highlights.contains(reused));
+    EXPECT_EQ(highlights.find(reused_again)->color, 3u);
+    EXPECT_TRUE(highlights.erase(reused_again));
+    EXPECT_EQ(highlights.size(), 2u);
+    EXPECT_TRUE(highlights.erase(neighbour));
+    EXPECT_EQ(highlights.size(), 1u);
+    EXPECT_FALSE(highlights.contains(reused));
+    EXPECT_FALSE(highlights.erase(reused));
+    EXPECT_EQ(highlights.entities().size(), 1u);
+
+    // chunk rows join the sparse values through their entity
+    auto archetype = archetype_system->get_or_create_archetype<aabb_component_t>();
+    punk::archetype_instance instance{ archetype };
+    auto* chunk = instance.allocate_row(punk::entity_t{ entity_handle_t{ 0 } }).chunk;
+    for(uint32_t index = 1; index < 10; ++index)
+    {
+        instance.allocate_row(punk::entity_t{ entity_handle_t{ index } });
+    }
+    EXPECT_EQ(instance.get_entities(chunk)[4].get_handle().get_value(), 4u);
+
+    punk::view<aabb_component_t const, highlight_component_t> highlight_view{ rtts.get() };
+    highlight_view.bind_sparse_storage<highlight_component_t>(&highlights);
+    EXPECT_TRUE(highlight_view.matches(archetype));
+    highlights.emplace(punk::entity_t{ entity_handle_t{ 6 } }, 9u);
+    uint32_t visited = 0, colors = 0;
+    highlight_view.for_each(archetype, chunk,
+        [&](aabb_component_t const&, highlight_component_t& highlight)
+        {
+            colors += highlight.color;
+            ++visited;
+        });
+    EXPECT_EQ(visited, 2u);
+    EXPECT_EQ(colors, 17u);
+
+    // a removed row takes its entity along
+    EXPECT_EQ(instance.free_row(chunk, 3), 9u);
+    EXPECT_EQ(instance.get_entities(chunk)[3].get_handle().get_value(), 9u);
+}
+
+TEST(ECS, WorldResources)
+{
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    punk::resource_registry_t world_resources{ rtts.get() };
+
+    EXPECT_EQ(world_resources.find<game_clock_t>(), nullptr);
+    world_resources.emplace<game_clock_t>(1.0, 0.5f);
+    world_resources.find<game_clock_t>()->time += 1.0;
+    EXPECT_EQ(world_resources.find(rtts->get_or_create_type_info<game_clock_t>()), world_resources.find<game_clock_t>());
+
+    // systems declare resource access like component access
+    using clock_reader = punk::resources<game_clock_t const>;
+    using clock_writer = punk::resources<game_clock_t, aabb_component_t>;
+    static_assert(!clock_reader::conflicts_with<clock_reader>());
+    static_assert(clock_reader::conflicts_with<clock_writer>());
+    static_assert(clock_writer::conflicts_with<punk::view<aabb_component_t const>>());
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(std::declval<clock_reader>().get<game_clock_t>())>>);
+
+    clock_reader reader{ &world_resources, rtts.get() };
+    EXPECT_EQ(reader.get<game_clock_t>().time, 2.0);
+    EXPECT_TRUE(reader.get_access()[0].read_only);
+    EXPECT_EQ(reader.get_access()[0].type, rtts->get_or_create_type_info<game_clock_t>());
+
+    clock_writer writer{ &world_resources, rtts.get() };
+    EXPECT_EQ(writer.find<aabb_component_t>(), nullptr);
+    writer.get<game_clock_t>().delta = 0.25f;
+    EXPECT_FALSE(writer.get_access()[0].read_only);
+
+    // the slot survives erase, a new value shows through existing accessors
+    EXPECT_TRUE(world_resources.erase<game_clock_t>());
+    EXPECT_EQ(reader.find<game_clock_t>(), nullptr);
+    world_resources.emplace<game_clock_t>().delta = 1.0f;
+    EXPECT_EQ(reader.get<game_clock_t>().delta, 1.0f);
+
+    // lookups never create slots, an accessor made before the first emplace resolves it on access
+    punk::resources<aabb_component_t const> early_reader{ &world_resources, rtts.get() };
+    EXPECT_EQ(std::as_const(world_resources).find<aabb_component_t>(), nullptr);
+    EXPECT_EQ(early_reader.find<aabb_component_t>(), nullptr);
+    world_resources.emplace<aabb_component_t>().min.x = 3.0f;
+    EXPECT_EQ(early_reader.get<aabb_component_t>().min.x, 3.0f);
+}
+
+TEST(ECS, PrefabInstantiate)
+{
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    auto archetype = archetype_system->get_or_create_archetype<aabb_component_t, loot_component_t, stunned_component_t, frozen_tag_t>();
+    punk::prefab_t prefab{ archetype };
+    prefab.get<aabb_component_t>(rtts.get())->max = punk::float3{ 1.0f, 2.0f, 4.0f };
+    prefab.get<loot_component_t>(rtts.get())->name = "a name too long for the small string buffer";
+    auto const loot_column = punk::find_archetype_component(archetype.get(), rtts->get_or_create_type_info<loot_component_t>());
+    prefab.add_entity_reference(loot_column, offsetof(loot_component_t, owner));
+
+    // a wave larger than a chunk spills over into new chunks
+    auto const count = archetype->capacity_in_chunk * 2u + 7u;
+    std::vector<punk::entity_t> entities;
+    for(uint32_t index = 0; index < count; ++index)
+    {
+        entities.push_back(punk::entity_t{ entity_handle_t{ index }, 1 });
+    }
+    std::vector<punk::row_location_t> locations(count);
+    punk::archetype_instance instance{ archetype };
+    instance.instantiate(prefab, entities.data(), count, locations.data());
+    EXPECT_EQ(instance.get_chunk_count(), 3u);
+
+    punk::view<aabb_component_t const, loot_component_t const> loot_view{ rtts.get() };
+    uint32_t visited = 0;
+    instance.for_each_chunk(
+        [&](punk::chunk_t* chunk)
+        {
+            auto const* chunk_entities = instance.get_entities(chunk);
+            uint32_t row = 0;
+            loot_view.for_each(archetype, chunk,
+                [&](aabb_component_t const& aabb, loot_component_t const& loot)
+                {
+                    EXPECT_EQ(aabb.max.z, 4.0f);
+                    EXPECT_EQ(loot.name, "a name too long for the small string buffer");
+                    EXPECT_EQ(loot.owner.get_value(), chunk_entities[row++].get_value());
+                    ++visited;
+                });
+        });
+    EXPECT_EQ(visited, count);
+
+    // spawned rows start enabled, like allocated ones
+    auto const stunned_column = punk::find_archetype_component(archetype.get(), rtts->get_or_create_type_info<stunned_component_t>());
+    auto const frozen_column = punk::find_archetype_component(archetype.get(), rtts->get_or_create_type_info<frozen_tag_t>());
+    for(auto const& spawned : locations)
+    {
+        EXPECT_TRUE(instance.is_component_enabled(spawned.chunk, spawned.row, stunned_column));
+        EXPECT_TRUE(instance.is_component_enabled(spawned.chunk, spawned.row, frozen_column));
+    }
+    EXPECT_EQ(instance.get_entities(locations[count - 1].chunk)[locations[count - 1].row].get_value(), entities.back().get_value());
+
+    // single rows keep filling the chunk the wave left open
+    auto const location = instance.allocate_row(punk::entity_t{ entity_handle_t{ count } });
+    EXPECT_EQ(location.chunk, locations[count - 1].chunk);
+}
+
+TEST(ECS, ComponentEvents)
+{
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    auto archetype = archetype_system->get_or_create_archetype<aabb_component_t, name_component_t>();
+    punk::component_event_queues_t event_queues;
+    punk::archetype_instance instance{ archetype };
+    instance.set_event_queues(&event_queues);
+
+    // nothing is recorded before someone subscribes
+    instance.allocate_row(punk::entity_t{ entity_handle_t{ 0 } });
+    auto const* aabb_type = rtts->get_or_create_type_info<aabb_component_t>();
+    auto const added = event_queues.subscribe(aabb_type, punk::component_event_t::added);
+    auto const removed = event_queues.subscribe(aabb_type, punk::component_event_t::removed);
+    auto const changed = event_queues.subscribe(aabb_type, punk::component_event_t::changed);
+    EXPECT_TRUE(event_queues.peek(added).empty());
+
+    auto* chunk = instance.allocate_row(punk::entity_t{ entity_handle_t{ 1 } }).chunk;
+    instance.allocate_row(punk::entity_t{ entity_handle_t{ 2 } });
+    instance.free_row(chunk, 0);
+    event_queues.consume(added,
+        [](std::span<punk::entity_t const> entities)
+        {
+            ASSERT_EQ(entities.size(), 2u);
+            EXPECT_EQ(entities[1].get_handle().get_value(), 2u);
+        });
+    EXPECT_TRUE(event_queues.peek(added).empty());
+    ASSERT_EQ(event_queues.peek(removed).size(), 1u);
+    EXPECT_EQ(event_queues.peek(removed)[0].get_handle().get_value(), 0u);
+
+    // reads do not count as changes, writes mark the whole chunk once
+    punk::view<aabb_component_t const> reader{ rtts.get() };
+    punk::view<aabb_component_t, name_component_t const> writer{ rtts.get() };
+    instance.for_each(reader, [](aabb_component_t const&) {});
+    instance.flush_changed_events();
+    EXPECT_TRUE(event_queues.peek(changed).empty());
+    instance.for_each(writer, [](aabb_component_t& aabb, name_component_t const&) { aabb.min.x += 1.0f; });
+    instance.for_each(writer, [](aabb_component_t& aabb, name_component_t const&) { aabb.min.x += 1.0f; });
+    instance.flush_changed_events();
+    EXPECT_EQ(event_queues.peek(changed).size(), 2u);
+
+    // a chunk the view skipped was not written
+    writer.set_chunk_predicate([](punk::chunk_t const*) { return false; });
+    instance.for_each(writer, [](aabb_component_t& aabb, name_component_t const&) { aabb.min.x += 1.0f; });
+    instance.flush_changed_events();
+    EXPECT_EQ(event_queues.peek(changed).size(), 2u);
+
+    event_queues.unsubscribe(changed);
+    event_queues.unsubscribe(added);
+    event_queues.unsubscribe(removed);
+    EXPECT_FALSE(event_queues.has_subscribers());
+}
+
+TEST(ECS, ChunkFilters)
+{
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    // three chunks created at versions 1, 1 & 2
+    auto archetype = archetype_system->get_or_create_archetype<aabb_component_t, stunned_component_t>();
+    auto const stunned_column = punk::find_archetype_component(archetype.get(), rtts->get_or_create_type_info<stunned_component_t>());
+    punk::archetype_instance instance{ archetype };
+    instance.set_change_version(1);
+    std::vector<punk::chunk_t*> chunks;
+    for(uint32_t index = 0; index < archetype->capacity_in_chunk * 3u; ++index)
+    {
+        if(index == archetype->capacity_in_chunk * 2u)
+        {
+            instance.set_change_version(2);
+        }
+        auto const location = instance.allocate_row(punk::entity_t{ entity_handle_t{ index } });
+        if(location.row == 0)
+        {
+            chunks.push_back(location.chunk);
+        }
+    }
+    EXPECT_EQ(instance.get_change_version(chunks[2], 0), 2u);
+
+    punk::view<aabb_component_t, stunned_component_t const> mover{ rtts.get() };
+    auto const run = [&](auto& view)
+        {
+            uint32_t rows = 0;
+            for(auto* chunk : chunks)
+            {
+                view.for_each(archetype, chunk, [&](auto&...) { ++rows; });
+            }
+            return rows;
+        };
+
+    // only the chunk written after version 1 passes
+    mover.set_changed_filter<aabb_component_t>(1);
+    EXPECT_EQ(run(mover), archetype->capacity_in_chunk);
+    EXPECT_EQ(mover.get_stats().chunks_skipped_changed, 2u);
+
+    // writes stamp the visited chunks
+    mover.clear_changed_filters();
+    mover.set_write_version(3);
+    mover.set_chunk_predicate([&](punk::chunk_t const* chunk) { return chunk != chunks[0]; });
+    EXPECT_EQ(run(mover), archetype->capacity_in_chunk * 2u);
+    EXPECT_EQ(mover.get_stats().chunks_skipped_predicate, 1u);
+    EXPECT_EQ(instance.get_change_version(chunks[0], 0), 1u);
+    EXPECT_EQ(instance.get_change_version(chunks[1], 0), 3u);
+
+    // a chunk without enabled rows is skipped as a whole
+    for(uint32_t row = 0; row < archetype->capacity_in_chunk; ++row)
+    {
+        instance.set_component_enabled(chunks[1], row, stunned_column, false);
+    }
+    mover.reset_stats();
+    mover.set_write_version(0);
+    EXPECT_EQ(run(mover), archetype->capacity_in_chunk);
+    EXPECT_EQ(mover.get_stats().chunks_skipped_enabled, 1u);
+    EXPECT_EQ(mover.get_stats().chunks_visited, 1u);
+}
+
+TEST(ECS, EntityHierarchy)
+{
+    auto const entity = [](uint32_t handle) { return punk::entity_t{ entity_handle_t{ handle }, 1 }; };
+
+    // 0 -> { 1 -> { 3, 4 }, 2 }, 5 -> { 6 }
+    punk::entity_hierarchy hierarchy;
+    hierarchy.set_parent(entity(1), entity(0));
+    hierarchy.set_parent(entity(2), entity(0));
+    hierarchy.set_parent(entity(3), entity(1));
+    hierarchy.set_parent(entity(4), entity(1));
+    hierarchy.set_parent(entity(6), entity(5));
+    EXPECT_EQ(hierarchy.get_children(entity(1)).size(), 2u);
+    EXPECT_EQ(hierarchy.get_roots().size(), 2u);
+    EXPECT_TRUE(hierarchy.is_ancestor(entity(0), entity(4)));
+
+    auto const walk = [&]()
+        {
+            std::string order;
+            hierarchy.for_each_depth_first(
+                [&](punk::entity_t node, punk::entity_t parent, uint32_t depth)
+                {
+                    // parents are always visited first, transforms can propagate in one pass
+                    EXPECT_EQ(depth == 0, !parent.is_valid());
+                    order += std::to_string(node.get_handle().get_value());
+                });
+            return order;
+        };
+    EXPECT_EQ(walk(), "0134256");
+
+    // reparenting moves the whole subtree, the last sibling fills the hole
+    hierarchy.set_parent(entity(1), entity(6));
+    EXPECT_EQ(hierarchy.get_parent(entity(1)).get_value(), entity(6).get_value());
+    EXPECT_EQ(hierarchy.get_children(entity(0)).size(), 1u);
+    EXPECT_EQ(walk(), "0256134");
+
+    uint32_t max_depth = 0;
+    hierarchy.for_each_depth_first(entity(5), [&](punk::entity_t, punk::entity_t, uint32_t depth) { max_depth = (std::max)(max_depth, depth); });
+    EXPECT_EQ(max_depth, 3u);
+
+    // children of an erased entity become roots
+    EXPECT_TRUE(hierarchy.erase(entity(1)));
+    EXPECT_FALSE(hierarchy.contains(entity(1)));
+    EXPECT_TRUE(hierarchy.get_children(entity(6)).empty());
+    EXPECT_EQ(hierarchy.get_roots().size(), 4u);
+    EXPECT_EQ(walk(), "025634");
+}
+
+TEST(ECS, SpatialReorder)
+{
+    std::unique_ptr<punk::runtime_type_registry_t> rtts
+    {
+        punk::runtime_type_registry_t::create_instance()
+    };
+    std::unique_ptr<punk::archetype_registry_t> archetype_system
+    {
+        punk::archetype_registry_t::create_instance(rtts.get())
+    };
+
+    static_assert(punk::morton_encode3(1, 0, 0) == 1 && punk::morton_encode3(0, 1, 0) == 2 && punk::morton_encode3(0, 0, 1) == 4);
+    static_assert(punk::morton_encode3(3, 3, 3) == 63);
+
+    // rows inserted in reverse spatial order over three chunks
+    auto archetype = archetype_system->get_or_create_archetype<aabb_component_t, name_component_t, frozen_tag_t>();
+    auto const aabb_column = punk::find_archetype_component(archetype.get(), rtts->get_or_create_type_info<aabb_component_t>());
+    auto const name_column = punk::find_archetype_component(archetype.get(), rtts->get_or_create_type_info<name_component_t>());
+    auto const frozen_column = punk::find_archetype_component(archetype.get(), rtts->get_or_create_type_info<frozen_tag_t>());
+    punk::archetype_instance instance{ archetype };
+    auto const count = archetype->capacity_in_chunk * 2u + 11u;
+    std::unordered_map<uint64_t, punk::row_location_t> locations;
+    for(uint32_t index = 0; index < count; ++index)
+    {
+        auto const entity = punk::entity_t{ entity_handle_t{ index } };
+        auto const location = instance.allocate_row(entity);
+        auto& aabb = reinterpret_cast<aabb_component_t*>(instance.get_column(location.chunk, aabb_column))[location.row];
+        aabb.min = punk::float3{ static_cast<float>(count - index), 0.0f, 0.0f };
+        reinterpret_cast<name_component_t*>(instance.get_column(location.chunk, name_column))[location.row].name = std::to_string(index);
+        // a tag has no column, its enable bit still has to move with the row
+        instance.set_component_enabled(location.chunk, location.row, frozen_column, index % 3 != 0);
+        locations[entity.get_value()] = location;
+    }
+
+    instance.begin_reorder(
+        [&](punk::chunk_t* chunk, uint32_t row)
+        {
+            auto const& aabb = reinterpret_cast<aabb_component_t const*>(instance.get_column(chunk, aabb_column))[row];
+            return punk::morton_encode3(static_cast<uint32_t>(aabb.min.x), static_cast<uint32_t>(aabb.min.y), static_cast<uint32_t>(aabb.min.z));
+        });
+
+    // bounded work per step, the owner hears about every moved row
+    uint32_t steps = 0;
+    auto const on_moved = [&](punk::entity_t entity, punk::row_location_t location) { locations[entity.get_value()] = location; };
+    while(!instance.reorder_step(16, on_moved))
+    {
+        ++steps;
+    }
+    EXPECT_GE(steps, count / 2 / 16);
+
+    // rows now follow the key across chunks & still carry their own components
+    float previous = 0.0f;
+    uint32_t visited = 0;
+    instance.for_each_chunk(
+        [&](punk::chunk_t* chunk)
+        {
+            auto const* entities = instance.get_entities(chunk);
+            for(uint32_t row = 0; row < chunk->element_count; ++row, ++visited)
+            {
+                auto const& aabb = reinterpret_cast<aabb_component_t const*>(instance.get_column(chunk, aabb_column))[row];
+                EXPECT_GT(aabb.min.x, previous);
+                previous = aabb.min.x;
+
+                auto const handle = entities[row].get_handle().get_value();
+                EXPECT_EQ(reinterpret_cast<name_component_t const*>(instance.get_column(chunk, name_column))[row].name, std::to_string(handle));
+                EXPECT_EQ(aabb.min.x, static_cast<float>(count - handle));
+                EXPECT_EQ(instance.is_component_enabled(chunk, row, frozen_column), handle % 3 != 0);
+                EXPECT_EQ(locations[entities[row].get_value()].chunk, chunk);
+                EXPECT_EQ(locations[entities[row].get_value()].row, row);
+            }
+        });
+    EXPECT_EQ(visited, count);
+
+    // freeing a row drops a pending plan
+    instance.begin_reorder([](punk::chunk_t*, uint32_t row) { return uint64_t{ row }; });
+    EXPECT_TRUE(instance.is_reordering());
+    instance.free_row(locations.begin()->second.chunk, locations.begin()->second.row);
+    EXPECT_FALSE(instance.is_reordering());
+}
@@ -107,4 +107,58 @@ TEST(PunkRTTI, Reflection)
         std::cout << "field type name:" << field.type->name << std::endl;
         std::cout << "field offset:" << field.offset << std::endl;
     }
-}
\ No newline at end of file
+}
+
+TEST(PunkRTTI, StaticTypeName)
+{
+    static_assert(punk::get_static_type_name<fee>() == "fee");
+    static_assert(punk::type_info_traits<fee>::get_type_name_hash() == punk::hash_memory("fee"));
+    static_assert(punk::type_info_traits<punk::uint32_t>::get_type_name_hash() == punk::hash_memory("uint32"));
+
+    std::unique_ptr<punk::runtime_type_registry_t> rtti{ punk::runtime_type_registry_t::create_instance() };
+    auto const* fee_type_info = rtti->get_or_create_type_info<fee>();
+    EXPECT_EQ(fee_type_info->name, "fee");
+    EXPECT_EQ(fee_type_info->hash.value0, punk::type_info_traits<fee>::get_type_name_hash());
+    EXPECT_EQ(rtti->get_type_info("fee"), fee_type_info);
+
+    // cached per registry, a new registry never sees the old type info
+    EXPECT_EQ(rtti->get_or_create_type_info<fee>(), fee_type_info);
+    std::unique_ptr<punk::runtime_type_registry_t> other_rtti{ punk::runtime_type_registry_t::create_instance() };
+    EXPECT_EQ(other_rtti->get_type_info("fee"), nullptr);
+    EXPECT_NE(other_rtti->get_or_create_type_info<fee>(), fee_type_info);
+}
+
+TEST(PunkRTTI, VTableRangeOperations)
+{
+    constexpr auto trivial_vtable = punk::type_info_traits<fee>::get_vtable();
+    static_assert(trivial_vtable.trivially_copyable && trivial_vtable.trivially_relocatable);
+    static_assert(trivial_vtable.copy_n == nullptr && trivial_vtable.relocate_n == nullptr);
+    constexpr auto string_vtable = punk::type_info_traits<test_align>::get_vtable();
+    static_assert(!string_vtable.trivially_copyable && !string_vtable.trivially_relocatable);
+
+    std::unique_ptr<punk::runtime_type_registry_t> rtti{ punk::runtime_type_registry_t::create_instance() };
+    auto const* type_info = rtti->get_or_create_type_info<test_align>();
+
+    constexpr size_t count = 4;
+    alignas(test_align) std::byte src_storage[sizeof(test_align) * count];
+    alignas(test_align) std::byte dst_storage[sizeof(test_align) * count];
+    auto* src = reinterpret_cast<test_align*>(src_storage);
+    auto* dst = reinterpret_cast<test_align*>(dst_storage);
+
+    punk::construct_objects(type_info, src, count);
+    for(size_t loop = 0; loop < count; ++loop)
+    {
+        EXPECT_EQ(src[loop].int_value, 0);
+        src[loop].str_value = std::string(32, static_cast<char>('a' + loop));
+    }
+
+    punk::construct_objects(type_info, dst, count);
+    punk::copy_objects(type_info, dst, src, count);
+    EXPECT_EQ(dst[3].str_value, std::string(32, 'd'));
+    punk::destroy_objects(type_info, dst, count);
+
+    // src is destroyed by the relocation
+    punk::relocate_objects(type_info, dst, src, count);
+    EXPECT_EQ(dst[2].str_value, std::string(32, 'c'));
+    punk::destroy_objects(type_info, dst, count);
+}
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+#include "Base/Types.h"
+#include "Base/Utils/Hash.h"
+#include "Base/Async/EpochDomain.h"
+#include <algorithm>
+#include <random>
+
+TEST(PunkUtils, HashMemory64)
+{
+    // compile time keys
+    static_assert(punk::hash_memory64("float3") != punk::hash_memory64("float4"));
+    static_assert(punk::hash_memory64("float3", 1) != punk::hash_memory64("float3", 2));
+    constexpr auto payload = []()
+    {
+        std::array<char, 3000> bytes{};
+        for(size_t loop = 0; loop < bytes.size(); ++loop)
+        {
+            bytes[loop] = static_cast<char>(loop * 131 + 7);
+        }
+        return bytes;
+    }();
+    constexpr auto payload_hash = punk::hash_memory64(payload.data(), payload.size());
+    EXPECT_EQ(punk::hash_memory64(payload.data(), payload.size()), payload_hash);
+
+    // every kernel level agrees with the scalar reference, at any length & alignment
+    std::mt19937_64 engine{ 42 };
+    std::vector<char> bytes(20 * 1024);
+    std::ranges::generate(bytes, [&]() { return static_cast<char>(engine()); });
+    for(size_t const len : { 0, 1, 3, 4, 8, 16, 17, 48, 49, 255, 256, 257, 1023, 1024, 1025, 2049, 16 * 1024 })
+    {
+        for(size_t const offset : { 0, 1, 5 })
+        {
+            auto const* data = bytes.data() + offset;
+            auto const expected = len <= punk::detail::hash_bulk_threshold
+                ? punk::detail::wyhash(data, len, 7)
+                : punk::detail::hash_bulk(data, len, 7, punk::detail::scalar_hash_kernels::accumulate, punk::detail::scalar_hash_kernels::scramble);
+            EXPECT_EQ(punk::hash_memory64(data, len, 7), expected);
+
+            // every level this cpu supports, not only the one picked at startup
+            auto const detected_level = static_cast<uint8_t>(punk::detail::detect_hash_kernel_level());
+            for(uint8_t level = 0; len > punk::detail::hash_bulk_threshold && level <= detected_level; ++level)
+            {
+                auto const kernels = punk::detail::make_hash_kernels(static_cast<punk::detail::hash_kernel_level>(level));
+                ASSERT_EQ(static_cast<uint8_t>(kernels.level), level);
+                EXPECT_EQ(punk::detail::hash_bulk(data, len, 7, kernels.accumulate, kernels.scramble), expected);
+            }
+        }
+    }
+
+    // reordering stripes inside a block changes the hash
+    std::vector<char> swapped(bytes.begin(), bytes.begin() + 1024);
+    std::swap_ranges(swapped.begin(), swapped.begin() + 64, swapped.begin() + 64);
+    EXPECT_NE(punk::hash_memory64(swapped.data(), swapped.size()), punk::hash_memory64(bytes.data(), 1024));
+}
+
+TEST(PunkUtils, EpochDomain)
+{
+    struct tracked_t
+    {
+        int* destroyed;
+        ~tracked_t() { ++*destroyed; }
+    };
+
+    int destroyed = 0;
+    punk::epoch_domain domain;
+    {
+        // retired while pinned, kept until the reader leaves
+        auto guard = domain.pin();
+        domain.retire(new tracked_t{ &destroyed });
+        EXPECT_EQ(domain.collect(), 0u);
+        EXPECT_EQ(destroyed, 0);
+    }
+    EXPECT_EQ(domain.collect(), 1u);
+    EXPECT_EQ(destroyed, 1);
+
+    // a reader pinned after the retirement does not hold it back
+    domain.retire(new tracked_t{ &destroyed });
+    {
+        domain.collect();
+        auto guard = domain.pin();
+        domain.collect();
+        EXPECT_EQ(destroyed, 2);
+    }
+
+    // leftovers are freed with the domain
+    {
+        punk::epoch_domain scoped_domain;
+        auto guard = scoped_domain.pin();
+        scoped_domain.retire(new tracked_t{ &destroyed });
+        guard.release();
+    }
+    EXPECT_EQ(destroyed, 3);
+}